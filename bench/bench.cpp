@@ -0,0 +1,514 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+/**
+ * SOLYS BENCHMARKS
+ * 		Build with "make bench", run "bin/solys-bench [options]".
+ * 		Every case uses a seeded Scenario, so runs on the same machine are comparable.
+ * 		The results are written as json, --baseline compares them to an older run.
+ * 		Every case runs in its own process, so its peak memory use isn't hidden by an earlier case.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "world.hpp"
+#include "scenario.hpp"
+#include "snapshot.hpp"
+#include "renderer.hpp"
+#include "gravity.hpp"
+#include "version.hpp"
+
+/**
+ * @brief One measured case
+ */
+struct Result
+{
+	std::string name;
+	std::string group;
+	std::string solver;
+	std::string scenario;
+	std::size_t bodies;
+
+	double seconds;				// best time of one repetition
+	double ns_per_body;
+	double ns_per_interaction;	// direct solvers only, else 0
+	double per_second;			// steps/s, spawns/s or snapshots/s
+	long peak_rss_kb;			// of the process running only this case
+};
+
+/**
+ * @brief Options from the command line
+ */
+struct Options
+{
+	std::size_t max_bodies = 100000;
+	std::size_t max_direct_bodies = 20000;
+	unsigned int threads = 1;
+	double min_time = 0.2;
+	std::string output;
+	std::string baseline;
+};
+
+static const World::Solver solvers[] =
+{
+	World::Solver::direct,
+	World::Solver::direct_symmetric,
+	World::Solver::barnes_hut
+};
+
+static const Scenario::Type scenarios[] =
+{
+	Scenario::Type::random,
+	Scenario::Type::disk
+};
+
+static const std::size_t body_counts[] = { 100, 1000, 10000, 100000 };
+
+/* HELPERS */
+
+/**
+ * @brief Run func until at least min_time passed and at least 3 times
+ * @return The best time of one run in s
+ */
+static double measure(const std::function<void()>& func, const double min_time)
+{
+	typedef std::chrono::steady_clock Clock;
+
+	double best = 1e300, total = 0.0;
+	unsigned int runs = 0;
+
+	while (runs < 3 || total < min_time)
+	{
+		const Clock::time_point start = Clock::now();
+		func();
+		const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		best = std::min(best, seconds);
+		total += seconds;
+		runs++;
+	}
+
+	return best;
+}
+
+/**
+ * @brief Create a World with the settings of a case
+ */
+static void setup(World& world, const Options& options, const World::Solver solver,
+	const Scenario::Type scenario, const std::size_t bodies)
+{
+	world.set_threads(options.threads);
+	world.set_solver(solver);
+	world.set_softening(1.0f);
+	Scenario::create(world, scenario, bodies, 42, 20000.0f);
+}
+
+static Result make_result(const std::string group, const std::string solver,
+	const Scenario::Type scenario, const std::size_t bodies, const double seconds)
+{
+	Result result;
+	result.group = group;
+	result.solver = solver;
+	result.scenario = Scenario::get_name(scenario);
+	result.bodies = bodies;
+	result.name = group + "/" + (solver.empty() ? "" : solver + "/") + result.scenario + "/" + std::to_string(bodies);
+	result.seconds = seconds;
+	result.ns_per_body = seconds * 1e9 / bodies;
+	result.ns_per_interaction = 0.0;
+	result.per_second = 1.0 / seconds;
+	result.peak_rss_kb = 0;
+	return result;
+}
+
+/* BENCHMARKS */
+
+/**
+ * @brief One force calculation, without moving the bodies
+ */
+static Result bench_force(const Options& options, const World::Solver solver,
+	const Scenario::Type scenario, const std::size_t bodies)
+{
+	World world(0.081f);
+	setup(world, options, solver, scenario, bodies);
+
+	const double seconds = measure([&] { world.compute_accelerations(); }, options.min_time);
+	Result result = make_result("force", World::get_solver_name(solver), scenario, bodies, seconds);
+
+	// pairs actually evaluated
+	const double n = (double)bodies;
+	if (solver == World::Solver::direct)
+	{
+		result.ns_per_interaction = seconds * 1e9 / (n * n);
+	}
+	else if (solver == World::Solver::direct_symmetric)
+	{
+		result.ns_per_interaction = seconds * 1e9 / (n * (n - 1.0) / 2.0);
+	}
+
+	return result;
+}
+
+/**
+ * @brief One full step with the default integrator
+ */
+static Result bench_step(const Options& options, const World::Solver solver,
+	const Scenario::Type scenario, const std::size_t bodies)
+{
+	World world(0.081f);
+	setup(world, options, solver, scenario, bodies);
+
+	const double seconds = measure([&] { world.update(0.01f); }, options.min_time);
+	return make_result("step", World::get_solver_name(solver), scenario, bodies, seconds);
+}
+
+/**
+ * @brief Spawning all bodies of a scenario into an empty World
+ */
+static Result bench_spawn(const Options& options, const Scenario::Type scenario, const std::size_t bodies)
+{
+	const double seconds = measure([&]
+	{
+		World world(0.081f);
+		Scenario::create(world, scenario, bodies, 42, 20000.0f);
+	}, options.min_time);
+
+	Result result = make_result("spawn", "", scenario, bodies, seconds);
+	result.per_second = bodies / seconds;
+	return result;
+}
+
+/**
+ * @brief Finding the overlapping bodies, without merging them
+ */
+static Result bench_collisions(const Options& options, const Scenario::Type scenario, const std::size_t bodies)
+{
+	World world(0.081f);
+	setup(world, options, World::Solver::barnes_hut, scenario, bodies);
+
+	Collisions collisions;
+	std::vector<Collisions::Pair> pairs;
+	const double seconds = measure([&] { collisions.find(world.get_particles(), pairs); }, options.min_time);
+	return make_result("collisions", "", scenario, bodies, seconds);
+}
+
+/**
+ * @brief Everything done for the renderer each frame, without the draw call
+ */
+static Result bench_render_prep(const Options& options, const Scenario::Type scenario, const std::size_t bodies)
+{
+	World world(0.081f);
+	setup(world, options, World::Solver::barnes_hut, scenario, bodies);
+
+	// a view around the whole world, so every body is drawn
+	const sf::FloatRect view(-1e6f, -1e6f, 2e6f, 2e6f);
+
+	Snapshot snapshot;
+	Renderer renderer;
+	const double seconds = measure([&]
+	{
+		snapshot.capture(world, 0.0, 0.0f);
+		renderer.prepare(snapshot, 1.0f, 1.0f, view);
+	}, options.min_time);
+	return make_result("render-prep", "", scenario, bodies, seconds);
+}
+
+/**
+ * @brief Run a benchmark in a child process and measure its peak resident set size.
+ * 		getrusage of the benchmark process itself only reports the peak of all cases so far.
+ * @param bench The benchmark
+ * @param result Gets the Result of the benchmark
+ * @return False if the child couldn't be started or failed
+ */
+static bool run_isolated(const std::function<Result()>& bench, Result& result)
+{
+	int fds[2];
+	if (pipe(fds) != 0)
+	{
+		return false;
+	}
+
+	const pid_t pid = fork();
+	if (pid < 0)
+	{
+		close(fds[0]);
+		close(fds[1]);
+		return false;
+	}
+
+	if (pid == 0)
+	// child, send the result as one field per line
+	{
+		close(fds[0]);
+
+		const Result r = bench();
+		std::ostringstream out;
+		out.precision(17);
+		out << r.name << "\n" << r.group << "\n" << r.solver << "\n" << r.scenario << "\n"
+			<< r.bodies << " " << r.seconds << " " << r.ns_per_body << " "
+			<< r.ns_per_interaction << " " << r.per_second << "\n";
+
+		const std::string data = out.str();
+		std::size_t written = 0;
+		while (written < data.size())
+		{
+			const ssize_t n = write(fds[1], data.data() + written, data.size() - written);
+			if (n <= 0)
+			{
+				_exit(1);
+			}
+			written += (std::size_t)n;
+		}
+
+		// skip the destructors of the parent's state
+		_exit(0);
+	}
+
+	close(fds[1]);
+
+	std::string data;
+	char buffer[256];
+	ssize_t n;
+	while ((n = read(fds[0], buffer, sizeof(buffer))) > 0)
+	{
+		data.append(buffer, (std::size_t)n);
+	}
+	close(fds[0]);
+
+	// the usage of this child alone, RUSAGE_CHILDREN would be the peak of all of them
+	int status;
+	rusage usage;
+	if (wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+	{
+		return false;
+	}
+
+	std::istringstream in(data);
+	std::getline(in, result.name);
+	std::getline(in, result.group);
+	std::getline(in, result.solver);
+	std::getline(in, result.scenario);
+	in >> result.bodies >> result.seconds >> result.ns_per_body >> result.ns_per_interaction >> result.per_second;
+	result.peak_rss_kb = usage.ru_maxrss;
+
+	return (bool)in;
+}
+
+/* OUTPUT */
+
+static std::string to_json(const std::vector<Result>& results, const Options& options)
+{
+	std::ostringstream json;
+	json.precision(6);
+
+	json << "{\n"
+		<< "\t\"version\": \"" << SOLYS_VERSION << "\",\n"
+		<< "\t\"isa\": \"" << Gravity::get_isa_name(Gravity::get_isa()) << "\",\n"
+		<< "\t\"threads\": " << options.threads << ",\n"
+		<< "\t\"results\": [\n";
+
+	for (std::size_t i = 0; i < results.size(); i++)
+	{
+		const Result& r = results[i];
+
+		// one result per line, --baseline relies on it
+		json << "\t\t{ \"name\": \"" << r.name << "\""
+			<< ", \"group\": \"" << r.group << "\""
+			<< ", \"solver\": \"" << r.solver << "\""
+			<< ", \"scenario\": \"" << r.scenario << "\""
+			<< ", \"bodies\": " << r.bodies
+			<< ", \"seconds\": " << r.seconds
+			<< ", \"ns_per_body\": " << r.ns_per_body
+			<< ", \"ns_per_interaction\": " << r.ns_per_interaction
+			<< ", \"per_second\": " << r.per_second
+			<< ", \"peak_rss_kb\": " << r.peak_rss_kb
+			<< " }" << (i + 1 < results.size() ? "," : "") << "\n";
+	}
+
+	json << "\t]\n}\n";
+	return json.str();
+}
+
+/**
+ * @brief Read the times of an older run
+ * @return Name to seconds
+ */
+static std::map<std::string, double> read_baseline(const std::string filename)
+{
+	std::map<std::string, double> times;
+	std::ifstream file(filename);
+	std::string line;
+
+	while (std::getline(file, line))
+	{
+		const std::size_t name = line.find("\"name\": \"");
+		const std::size_t seconds = line.find("\"seconds\": ");
+
+		if (name == std::string::npos || seconds == std::string::npos)
+		{
+			continue;
+		}
+
+		const std::size_t begin = name + 9;
+		const std::size_t end = line.find('"', begin);
+		times[line.substr(begin, end - begin)] = std::stod(line.substr(seconds + 11));
+	}
+
+	return times;
+}
+
+static void print_usage()
+{
+	std::cerr
+		<< "usage: solys-bench [--max-bodies N] [--max-direct-bodies N] [--threads N]\n"
+		<< "\t[--min-time S] [--output FILE] [--baseline FILE]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	const std::vector<std::string> args(argv + 1, argv + argc);
+
+	for (std::size_t i = 0; i < args.size(); i += 2)
+	{
+		if (i + 1 >= args.size())
+		{
+			print_usage();
+			return 1;
+		}
+
+		try
+		{
+			if (args[i] == "--max-bodies") options.max_bodies = std::stoul(args[i + 1]);
+			else if (args[i] == "--max-direct-bodies") options.max_direct_bodies = std::stoul(args[i + 1]);
+			else if (args[i] == "--threads") options.threads = (unsigned int)std::stoul(args[i + 1]);
+			else if (args[i] == "--min-time") options.min_time = std::stod(args[i + 1]);
+			else if (args[i] == "--output") options.output = args[i + 1];
+			else if (args[i] == "--baseline") options.baseline = args[i + 1];
+			else
+			{
+				print_usage();
+				return 1;
+			}
+		}
+		catch (...)
+		{
+			print_usage();
+			return 1;
+		}
+	}
+
+	std::vector<Result> results;
+
+	auto report = [&](const std::function<Result()>& bench)
+	{
+		Result result;
+		if (!run_isolated(bench, result))
+		{
+			std::cerr << "A benchmark failed" << std::endl;
+			return false;
+		}
+
+		std::cerr << result.name << ": " << result.seconds * 1e3 << " ms" << std::endl;
+		results.push_back(result);
+		return true;
+	};
+
+	for (const std::size_t bodies: body_counts)
+	{
+		if (bodies > options.max_bodies)
+		{
+			continue;
+		}
+
+		for (const Scenario::Type scenario: scenarios)
+		{
+			for (const World::Solver solver: solvers)
+			{
+				// O(N^2) gets too slow for the largest worlds
+				if (solver != World::Solver::barnes_hut && bodies > options.max_direct_bodies)
+				{
+					continue;
+				}
+
+				if (!report([&] { return bench_force(options, solver, scenario, bodies); })
+					|| !report([&] { return bench_step(options, solver, scenario, bodies); }))
+				{
+					return 1;
+				}
+			}
+
+			if (!report([&] { return bench_spawn(options, scenario, bodies); })
+				|| !report([&] { return bench_collisions(options, scenario, bodies); })
+				|| !report([&] { return bench_render_prep(options, scenario, bodies); }))
+			{
+				return 1;
+			}
+		}
+	}
+
+	const std::string json = to_json(results, options);
+
+	if (options.output.empty())
+	{
+		std::cout << json;
+	}
+	else
+	{
+		std::ofstream(options.output) << json;
+	}
+
+	if (!options.baseline.empty())
+	{
+		const std::map<std::string, double> baseline = read_baseline(options.baseline);
+
+		std::cerr << "\ncompared to " << options.baseline << " (>1 is slower):" << std::endl;
+
+		for (const auto& result: results)
+		{
+			const auto it = baseline.find(result.name);
+
+			if (it != baseline.end() && it->second > 0.0)
+			{
+				std::cerr << result.name << ": " << result.seconds / it->second << std::endl;
+			}
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+
+/**
+ * @brief Convert values between the byte order of the machine and little-endian, the order of all files.
+ * 		Does nothing on little-endian machines, swapping twice gives the original value.
+ * @param data The values, converted in place
+ * @param count The number of values
+ */
+template<typename T>
+inline void to_little_endian(T* data, const std::size_t count)
+{
+	if constexpr (std::endian::native == std::endian::big)
+	{
+		for (std::size_t i = 0; i < count; i++)
+		{
+			unsigned char* bytes = reinterpret_cast<unsigned char*>(data + i);
+			std::reverse(bytes, bytes + sizeof(T));
+		}
+	}
+	else
+	{
+		(void)data;
+		(void)count;
+	}
+}
\ No newline at end of file
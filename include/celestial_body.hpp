@@ -36,45 +36,34 @@ public: /* PUBLIC FUNCS */
 
 	/**
 	 * @brief Constructor to create a celestial body with density and radius, and a color.
+	 * @param particles The ParticleStore holding the physics state
 	 * @param density The density of the celestial in kg / m^3
 	 * @param radius The radius of the celestial in m
 	 * @param color The color of the celestial, default = sf::Color::White
 	 */
-	CelestialBody(const float density, const float radius,
+	CelestialBody(ParticleStore& particles, const float density, const float radius,
 		const sf::Color color = sf::Color::White);
 	
 	virtual ~CelestialBody() {};
 
 	/**
-	 * @brief Update a celestial relative to time
-	 * @param clock The delta time
-	 */
-	void update(const float time) override;
-
-	/**
-	 * @brief Draw a celestial
-	 * @param window The sf::RenderWindow to draw to
-	 */
-	void draw(sf::RenderWindow& window) override;
-
-	/**
-	 * @brief Set the origin by radius
-	 * @param radius The radius of the celestial in m
-	 */
-	void set_origin(const float radius);
-
-	/**
-	 * @brief Set the radius of the CelestialBody, automatically set's origin to (radius, radius)
+	 * @brief Set the radius of the CelestialBody
 	 * @param radius The radius
 	 */
 	void set_radius(const float radius);
 
 	/**
-	 * @brief Set the color of the shape
+	 * @brief Set the color the CelestialBody is drawn with
 	 * @param color The sf::Color
 	 */
 	void set_color(const sf::Color color);
 
+	/**
+	 * @brief Get the color the CelestialBody is drawn with
+	 * @return The sf::Color
+	 */
+	sf::Color get_color() const;
+
 	/**
 	 * @brief Calculate mass from volume and density; m = d * V;
 	 * @param density The density in kg / m^3
@@ -107,11 +96,4 @@ public: /* PUBLIC FUNCS */
 	 * @param density The density in kg / m^3
 	 */
 	void set_density(const float density);
-
-private: /* PRIVATE VARS */
-	float	density,
-			radius,
-			volume;
-
-	sf::CircleShape shape;
 };
\ No newline at end of file
@@ -0,0 +1,78 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "world.hpp"
+
+/**
+ * @brief Saves and restores all bodies of a World in a binary file.
+ * 		The file is little-endian: a Checkpoint::Header, then one array per field of all bodies,
+ * 		pos_x, pos_y, vel_x, vel_y, mass, radius, density as float, color as uint32,
+ * 		the name lengths as uint32 and all names after each other.
+ * 		Every array is read and written in one go, there is no parsing per body.
+ */
+class Checkpoint
+{
+public: /* PUBLIC TYPES */
+
+	struct Header
+	{
+		char magic[8];			// "SOLYSCHK"
+		std::uint32_t version;	// Checkpoint::version
+		std::uint32_t flags;	// unused, 0
+		std::uint64_t count;	// number of bodies
+		double time;			// simulated time in s
+	};
+
+public: /* PUBLIC FUNCS */
+
+	/**
+	 * @brief Write all bodies of a World to a file
+	 * @param world The World
+	 * @param time The simulated time in s
+	 * @param filename The filename of the checkpoint
+	 * @return False if the file couldn't be written
+	 */
+	static bool save(const World& world, const double time, const std::string filename);
+
+	/**
+	 * @brief Replace all bodies of a World with the ones of a file.
+	 * 		The World stays untouched if the file can't be read.
+	 * @param world The World
+	 * @param time Gets the simulated time in s
+	 * @param filename The filename of the checkpoint
+	 * @return False if the file couldn't be read or is no checkpoint of this version
+	 */
+	static bool load(World& world, double& time, const std::string filename);
+
+public: /* PUBLIC VARS */
+	static constexpr std::uint32_t version = 1;
+};
\ No newline at end of file
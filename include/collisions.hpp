@@ -0,0 +1,85 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "particle_store.hpp"
+
+/**
+ * @brief Finds overlapping bodies in about O(N) with a uniform grid stored in a hash table.
+ * 		The cells are four times the average radius, so a body only overlaps bodies
+ * 		in the 3x3 cells around its own. Bodies larger than half a cell are tested
+ * 		against every cell they cover instead.
+ */
+class Collisions
+{
+public: /* PUBLIC TYPES */
+
+	typedef std::pair<std::uint32_t, std::uint32_t> Pair;
+
+public: /* PUBLIC FUNCS */
+
+	/**
+	 * @brief Find all pairs of overlapping bodies
+	 * @param particles The ParticleStore
+	 * @param pairs Gets the pairs, first < second, sorted, cleared first
+	 */
+	void find(const ParticleStore& particles, std::vector<Pair>& pairs);
+
+private: /* PRIVATE FUNCS */
+
+	/**
+	 * @brief Get the cell of a coordinate
+	 */
+	std::int64_t get_cell(const float x) const;
+
+	/**
+	 * @brief Get the bucket of a cell in the hash table
+	 */
+	std::uint32_t get_bucket(const std::int64_t cell_x, const std::int64_t cell_y) const;
+
+	/**
+	 * @brief Add the overlaps of a body with all bodies in a cell
+	 */
+	void test_cell(const ParticleStore& particles, const std::uint32_t index,
+		const std::int64_t cell_x, const std::int64_t cell_y, std::vector<Pair>& pairs) const;
+
+private: /* PRIVATE VARS */
+	float cell_size = 1.0f;
+	std::uint32_t mask = 0;
+
+	// the small bodies sorted by bucket, bucket b holds bodies[bucket_start[b]] to bodies[bucket_start[b + 1]]
+	std::vector<std::uint32_t> bucket_start;
+	std::vector<std::uint32_t> bodies;
+	std::vector<std::uint32_t> body_buckets;
+
+	std::vector<std::uint32_t> large;
+};
\ No newline at end of file
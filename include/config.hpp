@@ -98,4 +98,17 @@ T Config::get_value(const std::string sname, const std::string vname) const
 {
 	throw "Unknown type!" + sname + ", " + vname;
 	return T();
-}
\ No newline at end of file
+}
+
+// the supported types, defined in config.cpp
+template<>
+std::string Config::get_value<std::string>(const std::string sname, const std::string vname) const;
+
+template<>
+unsigned int Config::get_value<unsigned int>(const std::string sname, const std::string vname) const;
+
+template<>
+float Config::get_value<float>(const std::string sname, const std::string vname) const;
+
+template<>
+bool Config::get_value<bool>(const std::string sname, const std::string vname) const;
\ No newline at end of file
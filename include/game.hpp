@@ -27,8 +27,14 @@
 
 #pragma once
 
+#include <optional>
+
 #include "sfml.hpp"
 #include "world.hpp"
+#include "simulation.hpp"
+#include "renderer.hpp"
+#include "replay.hpp"
+#include "gravity.hpp"
 #include "game_object.hpp"
 #include "celestial_body.hpp"
 #include "config.hpp"
@@ -52,7 +58,7 @@ public: /* PUBLIC TYPES */
 public: /* PUBLIC FUNCS */
 
 	/**
-	 * @brief Just clean up
+	 * @brief Just clean up, stops the simulation
 	 */
 	~Game();
 
@@ -81,6 +87,11 @@ private: /* PRIVATE FUNCS */
 	 */
 	void draw_ui();
 
+	/**
+	 * @brief Draw the controls of the open replay
+	 */
+	void draw_replay_ui();
+
 	/**
 	 * @brief Handle all queued sf::Events
 	 */
@@ -99,7 +110,24 @@ private: /* PRIVATE VARS */
 
 	sf::Clock clock;
 	World world = World(0.081f);
+	Simulation simulation = Simulation(world);
+	Renderer renderer;
+
+	// the newest state of the world, fetched once per frame
+	const Snapshot* snapshot = nullptr;
+
 	State state;
 
-	GameObject* selected_obj;
+	// the selected body
+	std::optional<Handle> selected_obj;
+
+	// where the File menu saves and loads the World
+	static constexpr const char* checkpoint_file = "data/checkpoint";
+
+	// where the File menu records to, and how many steps are between two frames
+	static constexpr const char* recording_file = "data/recording";
+	static constexpr unsigned int record_every = 10;
+
+	// shown instead of the World while a recording is open
+	Replay replay;
 };
\ No newline at end of file
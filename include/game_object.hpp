@@ -31,10 +31,12 @@
 #include <cmath>
 
 #include "sfml.hpp"
+#include "particle_store.hpp"
 
 /**
  * @brief Interface class for GameObject's.
  * 		Every GameObject should inherit from this class.
+ * 		The physics state lives in a ParticleStore, a GameObject is a handle to one particle of it.
  */
 class GameObject
 {
@@ -48,25 +50,14 @@ public:
 
 public: /* PUBLIC FUNCS */
 	/**
-	 * @brief Constructor to initialize a GameObject with a type
+	 * @brief Constructor to initialize a GameObject with a type, adds a new particle to the store
 	 * @param type The type of the GameObject
+	 * @param particles The ParticleStore holding the physics state
 	 */
-	GameObject(const Type type);
+	GameObject(const Type type, ParticleStore& particles);
 	virtual ~GameObject();
 
 	/* PUBLIC FUNCS */
-	/**
-	 * @brief Update the GameObject relative to time
-	 * @param clock Sfml clock with delta time
-	 */
-	virtual void update(const float time) = 0;
-
-	/**
-	 * @brief Draw GameObject to sf::RenderWindow
-	 * @param window The sf::RenderWindow
-	 */
-	virtual void draw(sf::RenderWindow& window) = 0;
-
 	/**
 	 * @brief Get the GameObject's position
 	 * @return The position
@@ -80,7 +71,7 @@ public: /* PUBLIC FUNCS */
 	sf::Vector2f get_vel() const;
 
 	/**
-	 * @brief Set the GameObject's position
+	 * @brief Set the GameObject's position, it is not interpolated from the old one
 	 * @param pos The position
 	 */
 	void set_pos(const sf::Vector2f pos);
@@ -111,6 +102,18 @@ public: /* PUBLIC FUNCS */
 	 */
 	float get_mass() const;
 
+	/**
+	 * @brief Get the index of the GameObject's particle in the ParticleStore
+	 * @return The index
+	 */
+	std::size_t get_index() const;
+
+	/**
+	 * @brief Change the index after the World moved the particle, only for the World
+	 * @param index The new index in the ParticleStore
+	 */
+	void set_index(const std::size_t index);
+
 	/**
 	 * @brief Calculate the magnitude of a vector.
 	 * 		||vec|| = sqrt(x * x + y * y);
@@ -221,9 +224,8 @@ public: /* PUBLIC FUNCS */
 	const Type type;
 
 protected: /* PROTECTED VARS */
-	sf::Vector2f pos, vel;
-	float mass;
+	ParticleStore& particles;
+	std::size_t index;
 
 	std::string name;
-	static unsigned int id;
 };
\ No newline at end of file
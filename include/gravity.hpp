@@ -0,0 +1,196 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#include "thread_pool.hpp"
+
+/**
+ * @brief Gravity kernels working directly on displacement vectors,
+ * 		no angles and no trigonometry are involved.
+ * 		G is left out of the per pair work, multiply the summed acceleration by it once.
+ */
+class Gravity
+{
+public: /* PUBLIC TYPES */
+
+	/**
+	 * @brief The instruction set used by the direct sum
+	 */
+	enum class Isa
+	{
+		scalar,
+		avx2,	// 8 bodies at once
+		avx512	// 16 bodies at once
+	};
+
+	/**
+	 * @brief The widest vector of bodies, ranges passed to Gravity::direct that start at
+	 * 		multiples of it give the same results, no matter how the bodies are split up.
+	 */
+	static constexpr std::size_t block_size = 16;
+
+public: /* PUBLIC FUNCS */
+
+	/**
+	 * @brief Add the acceleration a body causes at a distance; a += m * d / (|d|^2 + eps^2)^(3/2)
+	 * 		A body at distance 0 without softening causes no acceleration, so a body can be summed with itself.
+	 * @param d_x The distance on the x axis, from the accelerated position to the body, in m
+	 * @param d_y The distance on the y axis, from the accelerated position to the body, in m
+	 * @param m The mass of the body in kg
+	 * @param eps_sq The squared softening length in m^2
+	 * @param a_x The acceleration on the x axis to add to
+	 * @param a_y The acceleration on the y axis to add to
+	 */
+	static void accumulate(const float d_x, const float d_y, const float m, const float eps_sq,
+		float& a_x, float& a_y);
+
+	/**
+	 * @brief Calculate the accelerations of the bodies [begin, end) caused by all count bodies.
+	 * 		Uses the best instruction set of the cpu, see Gravity::set_isa.
+	 * @param G The gravitational constant in m^3 / (kg * s^2)
+	 * @param eps_sq The squared softening length in m^2
+	 * @param pos_x The positions on the x axis
+	 * @param pos_y The positions on the y axis
+	 * @param mass The masses in kg
+	 * @param count The number of bodies
+	 * @param begin The first accelerated body
+	 * @param end One past the last accelerated body
+	 * @param acc_x The accelerations on the x axis in m/s^2, overwritten for [begin, end)
+	 * @param acc_y The accelerations on the y axis in m/s^2, overwritten for [begin, end)
+	 */
+	static void direct(const float G, const float eps_sq,
+		const float* pos_x, const float* pos_y, const float* mass, const std::size_t count,
+		const std::size_t begin, const std::size_t end, float* acc_x, float* acc_y);
+
+	/**
+	 * @brief Calculate the accelerations at target_count positions caused by all count bodies,
+	 * 		e.g. of a few bodies gathered into contiguous arrays, so they still fill the vectors.
+	 * 		A target at the position of a body gets no acceleration from it.
+	 * @param G The gravitational constant in m^3 / (kg * s^2)
+	 * @param eps_sq The squared softening length in m^2
+	 * @param pos_x The positions on the x axis
+	 * @param pos_y The positions on the y axis
+	 * @param mass The masses in kg
+	 * @param count The number of bodies
+	 * @param target_x The accelerated positions on the x axis
+	 * @param target_y The accelerated positions on the y axis
+	 * @param target_count The number of accelerated positions
+	 * @param acc_x The accelerations on the x axis in m/s^2, one per target
+	 * @param acc_y The accelerations on the y axis in m/s^2, one per target
+	 */
+	static void direct_at(const float G, const float eps_sq,
+		const float* pos_x, const float* pos_y, const float* mass, const std::size_t count,
+		const float* target_x, const float* target_y, const std::size_t target_count,
+		float* acc_x, float* acc_y);
+
+	/**
+	 * @brief Calculate the accelerations of all bodies, visiting every pair only once
+	 * 		and applying equal and opposite accelerations to both bodies.
+	 * 		The bodies are split into tiles, pairs of tiles are scheduled in rounds where no tile
+	 * 		appears twice, so threads never write to the same body and the summation order
+	 * 		does not depend on the number of threads. Uses the same instruction set as Gravity::direct.
+	 * @param G The gravitational constant in m^3 / (kg * s^2)
+	 * @param eps_sq The squared softening length in m^2
+	 * @param pos_x The positions on the x axis
+	 * @param pos_y The positions on the y axis
+	 * @param mass The masses in kg
+	 * @param count The number of bodies
+	 * @param acc_x The accelerations on the x axis in m/s^2, overwritten
+	 * @param acc_y The accelerations on the y axis in m/s^2, overwritten
+	 * @param pool The threads to run on
+	 */
+	static void direct_symmetric(const float G, const float eps_sq,
+		const float* pos_x, const float* pos_y, const float* mass, const std::size_t count,
+		float* acc_x, float* acc_y, ThreadPool& pool);
+
+	/**
+	 * @brief Get the best instruction set the cpu supports
+	 * @return The Gravity::Isa
+	 */
+	static Isa detect_isa();
+
+	/**
+	 * @brief Choose the instruction set of the direct sum, falls back to the best supported one
+	 * @param isa The Gravity::Isa, Isa::scalar to compare against the plain kernel
+	 */
+	static void set_isa(const Isa isa);
+
+	/**
+	 * @brief Get the instruction set used by the direct sum
+	 * @return The Gravity::Isa
+	 */
+	static Isa get_isa();
+
+	/**
+	 * @brief Get the name of an instruction set
+	 * @param isa The Gravity::Isa
+	 * @return The name, e.g. "avx2"
+	 */
+	static const char* get_isa_name(const Isa isa);
+
+private: /* PRIVATE FUNCS */
+
+	/**
+	 * @brief Add the accelerations of all pairs between the bodies [a_begin, a_end) and [b_begin, b_end), without G
+	 */
+	static void accumulate_pairs(const float eps_sq,
+		const float* pos_x, const float* pos_y, const float* mass,
+		const std::size_t a_begin, const std::size_t a_end,
+		const std::size_t b_begin, const std::size_t b_end,
+		float* acc_x, float* acc_y);
+
+	/**
+	 * @brief Add the accelerations of all pairs within the bodies [begin, end), without G
+	 */
+	static void accumulate_pairs(const float eps_sq,
+		const float* pos_x, const float* pos_y, const float* mass,
+		const std::size_t begin, const std::size_t end,
+		float* acc_x, float* acc_y);
+
+private: /* PRIVATE VARS */
+	static Isa isa;
+
+	// bodies per tile of Gravity::direct_symmetric
+	static constexpr std::size_t tile_size = 256;
+};
+
+inline void Gravity::accumulate(const float d_x, const float d_y, const float m, const float eps_sq,
+	float& a_x, float& a_y)
+{
+	const float r_sq = d_x * d_x + d_y * d_y + eps_sq;
+
+	// one reciprocal square root per pair
+	const float inv_r = r_sq > 0.0f ? 1.0f / std::sqrt(r_sq) : 0.0f;
+	const float f = m * inv_r * inv_r * inv_r;
+
+	a_x += d_x * f;
+	a_y += d_y * f;
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Refers to a GameObject of a World without pointing to it.
+ * 		The index names a slot in the World, the generation counts how often the slot was reused.
+ * 		Once the GameObject is destroyed the generation of its slot changes, so old handles
+ * 		find nothing instead of another GameObject.
+ */
+struct Handle
+{
+	static constexpr std::uint32_t invalid = UINT32_MAX;
+
+	std::uint32_t index = invalid;
+	std::uint32_t generation = 0;
+
+	bool operator==(const Handle& other) const
+	{
+		return index == other.index && generation == other.generation;
+	}
+
+	bool operator!=(const Handle& other) const
+	{
+		return !(*this == other);
+	}
+};
\ No newline at end of file
@@ -0,0 +1,84 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "world.hpp"
+#include "config.hpp"
+#include "recorder.hpp"
+
+/**
+ * @brief Runs a scenario without window and ui, as fast as possible
+ */
+class Headless
+{
+public: /* PUBLIC FUNCS */
+
+	/**
+	 * @brief Load the settings and the scenario
+	 * @param config The settings
+	 * @param args The command line arguments, without the program name and "--headless"
+	 * @return False if the arguments or the scenario are invalid
+	 */
+	bool init(const Config& config, const std::vector<std::string> args);
+
+	/**
+	 * @brief Step the World until the step count or the simulated time is reached,
+	 * 		then write the results and print steps/second
+	 */
+	void run();
+
+	/**
+	 * @brief Print the command line usage
+	 */
+	static void print_usage();
+
+private: /* PRIVATE FUNCS */
+
+	/**
+	 * @brief Write the state of all bodies as csv
+	 * @param filename The filename of the output file
+	 * @return False if the file couldn't be written
+	 */
+	bool write_results(const std::string filename) const;
+
+private: /* PRIVATE VARS */
+	World world = World(0.081f);
+
+	float time_step;
+	unsigned long steps;
+	double end_time;
+	std::string output;
+
+	// every record_every steps are written to the file record, if set
+	Recorder recorder;
+	std::string record;
+	unsigned int record_every;
+};
\ No newline at end of file
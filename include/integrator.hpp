@@ -0,0 +1,262 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "particle_store.hpp"
+
+/**
+ * @brief Interface class for integrators, they move the particles of a ParticleStore forward in time.
+ * 		Every integrator should inherit from this class.
+ */
+class Integrator
+{
+public: /* PUBLIC TYPES */
+
+	enum class Type
+	{
+		euler,				// semi-implicit euler, 1st order
+		leapfrog,			// kick-drift-kick leapfrog, 2nd order, symplectic
+		velocity_verlet,	// velocity verlet, 2nd order, symplectic
+		yoshida,			// yoshida, 4th order, symplectic
+		block,				// leapfrog with power-of-two time-step levels per body, 2nd order
+		wisdom_holman		// kepler orbits around the heaviest body, the rest as kicks, 2nd order, symplectic
+	};
+
+	/**
+	 * @brief Calculates ParticleStore::acc_x and acc_y from the current positions
+	 */
+	typedef std::function<void()> Forces;
+
+	/**
+	 * @brief Calculates ParticleStore::acc_x and acc_y of some particles from the current positions of all
+	 */
+	typedef std::function<void(const std::vector<std::uint32_t>& active)> ActiveForces;
+
+public: /* PUBLIC FUNCS */
+
+	virtual ~Integrator() {};
+
+	/**
+	 * @brief Move all particles forward in time
+	 * @param particles The ParticleStore
+	 * @param forces Calculates the accelerations for the current positions
+	 * @param active_forces Calculates the accelerations of some particles for the current positions
+	 * @param time The delta time
+	 */
+	virtual void step(ParticleStore& particles, const Forces& forces, const ActiveForces& active_forces,
+		const float time) = 0;
+
+	/**
+	 * @brief Create an integrator
+	 * @param type The Integrator::Type
+	 * @param G The gravitational constant in m^3 / (kg * s^2), for integrators solving orbits themselves
+	 * @return The new integrator, owned by the caller
+	 */
+	static Integrator* create(const Type type, const float G);
+
+	/**
+	 * @brief Get the name of an integrator type
+	 * @param type The Integrator::Type
+	 * @return The name, e.g. "leapfrog"
+	 */
+	static const char* get_name(const Type type);
+
+protected: /* PROTECTED FUNCS */
+
+	/**
+	 * @brief Change all velocities by their acceleration; v += a * time
+	 * @param particles The ParticleStore
+	 * @param time The delta time
+	 */
+	static void kick(ParticleStore& particles, const float time);
+
+	/**
+	 * @brief Change all positions by their velocity; p += v * time
+	 * @param particles The ParticleStore
+	 * @param time The delta time
+	 */
+	static void drift(ParticleStore& particles, const float time);
+
+	/**
+	 * @brief Calculate the accelerations, unless they are still valid from the last step
+	 * @param particles The ParticleStore
+	 * @param forces Calculates the accelerations for the current positions
+	 */
+	static void ensure_accelerations(ParticleStore& particles, const Forces& forces);
+};
+
+/**
+ * @brief Kick then drift with the new velocity, what solys always did
+ */
+class EulerIntegrator : public Integrator
+{
+public: /* PUBLIC FUNCS */
+	void step(ParticleStore& particles, const Forces& forces, const ActiveForces& active_forces,
+		const float time) override;
+};
+
+/**
+ * @brief Half kick, drift, half kick; one force calculation per step,
+ * 		the accelerations of the end of a step are reused at the start of the next one
+ */
+class LeapfrogIntegrator : public Integrator
+{
+public: /* PUBLIC FUNCS */
+	void step(ParticleStore& particles, const Forces& forces, const ActiveForces& active_forces,
+		const float time) override;
+};
+
+/**
+ * @brief Drift with the old acceleration, then kick with the mean of old and new acceleration;
+ * 		one force calculation per step
+ */
+class VerletIntegrator : public Integrator
+{
+public: /* PUBLIC FUNCS */
+	void step(ParticleStore& particles, const Forces& forces, const ActiveForces& active_forces,
+		const float time) override;
+
+private: /* PRIVATE VARS */
+	std::vector<float> old_acc_x, old_acc_y;
+};
+
+/**
+ * @brief Three leapfrog steps with Yoshida's coefficients, 4th order;
+ * 		three force calculations per step, but allows much larger steps
+ */
+class YoshidaIntegrator : public Integrator
+{
+public: /* PUBLIC FUNCS */
+	void step(ParticleStore& particles, const Forces& forces, const ActiveForces& active_forces,
+		const float time) override;
+};
+
+/**
+ * @brief Leapfrog where every body steps on its own level, the step on level l is 2^l times shorter
+ * 		than the World step. The level follows from acceleration and jerk, so only bodies on
+ * 		close orbits take short steps. All bodies drift on the shortest step, but only the
+ * 		bodies ending their step get new accelerations.
+ */
+class BlockIntegrator : public Integrator
+{
+public: /* PUBLIC FUNCS */
+	void step(ParticleStore& particles, const Forces& forces, const ActiveForces& active_forces,
+		const float time) override;
+
+private: /* PRIVATE FUNCS */
+
+	/**
+	 * @brief Get the level a body should step on next
+	 * @param acc The magnitude of the acceleration
+	 * @param jerk The magnitude of the jerk
+	 * @param level The current level
+	 * @param time The World step
+	 * @param tick The tick the body ended its step on, it can only move to a coarser level
+	 * 		whose steps start there too
+	 * @return The level
+	 */
+	static std::uint8_t choose_level(const float acc, const float jerk, const std::uint8_t level,
+		const float time, const std::uint32_t tick);
+
+private: /* PRIVATE VARS */
+
+	// the finest level, 2^10 steps per World step
+	static constexpr std::uint8_t max_level = 10;
+
+	// the step of a body is eta * |a| / |j|
+	static constexpr float eta = 0.03f;
+
+	std::vector<std::uint32_t> active;
+	std::vector<float> old_acc_x, old_acc_y;
+};
+
+/**
+ * @brief Wisdom-Holman map in democratic heliocentric coordinates, like WHFast.
+ * 		Every body moves on its kepler orbit around the heaviest body, which is solved exactly,
+ * 		the gravity between the other bodies is applied as a kick in the middle of the step.
+ * 		One force calculation per step, steps can be a sizeable part of the shortest orbit
+ * 		as long as the heaviest body dominates. The orbits ignore the softening.
+ */
+class WisdomHolmanIntegrator : public Integrator
+{
+public: /* PUBLIC FUNCS */
+	WisdomHolmanIntegrator(const float G);
+
+	void step(ParticleStore& particles, const Forces& forces, const ActiveForces& active_forces,
+		const float time) override;
+
+private: /* PRIVATE FUNCS */
+
+	/**
+	 * @brief Move every body but the central one on its kepler orbit
+	 * @param time The delta time
+	 */
+	void kepler_drift(const double time);
+
+	/**
+	 * @brief Move every body but the central one by the momentum of the central one
+	 * @param particles The ParticleStore, for the masses
+	 * @param time The delta time
+	 */
+	void jump(const ParticleStore& particles, const double time);
+
+	/**
+	 * @brief Solve a kepler orbit with universal variables
+	 * @param mu G times the central mass
+	 * @param time The delta time
+	 * @param p_x The position on the x axis relative to the central body, updated
+	 * @param p_y The position on the y axis relative to the central body, updated
+	 * @param v_x The velocity on the x axis, updated
+	 * @param v_y The velocity on the y axis, updated
+	 */
+	static void solve_kepler(const double mu, const double time,
+		double& p_x, double& p_y, double& v_x, double& v_y);
+
+	/**
+	 * @brief Write the cartesian positions of all bodies
+	 * @param particles The ParticleStore
+	 */
+	void write_positions(ParticleStore& particles) const;
+
+private: /* PRIVATE VARS */
+	float G;
+
+	// index of the central body, its mass, the total mass,
+	// position and velocity of the center of mass
+	std::size_t central;
+	double central_mass, total_mass;
+	double center_x, center_y, center_vel_x, center_vel_y;
+
+	// positions relative to the central body, velocities relative to the center of mass
+	std::vector<double> rel_pos_x, rel_pos_y;
+	std::vector<double> bary_vel_x, bary_vel_y;
+};
\ No newline at end of file
@@ -0,0 +1,103 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Memory for many objects of up to one size, in large chunks.
+ * 		Slots never move, freed slots are reused first, so objects stay close together.
+ * 		Allocating and freeing is O(1), memory is only requested once per chunk.
+ * 		The pool doesn't construct or destroy the objects, the owner does.
+ */
+class ObjectPool
+{
+public: /* PUBLIC FUNCS */
+
+	/**
+	 * @brief Constructor, no memory is allocated yet
+	 * @param slot_size The size of one slot in bytes, rounded up to alignof(std::max_align_t)
+	 * @param slots_per_chunk The number of slots requested at once
+	 */
+	ObjectPool(const std::size_t slot_size, const std::size_t slots_per_chunk = 1024);
+
+	ObjectPool(const ObjectPool&) = delete;
+	ObjectPool& operator=(const ObjectPool&) = delete;
+
+	/**
+	 * @brief Get a free slot
+	 * @return The memory of the slot
+	 */
+	void* allocate();
+
+	/**
+	 * @brief Give a slot back, it is the next one allocate returns
+	 * @param slot The memory of the slot
+	 */
+	void free(void* slot);
+
+	/**
+	 * @brief Give all slots back at once, the chunks are kept for reuse
+	 */
+	void release();
+
+	/**
+	 * @brief Get the size of one slot
+	 * @return The size in bytes
+	 */
+	std::size_t get_slot_size() const;
+
+	/**
+	 * @brief Get the number of allocated slots
+	 * @return The number of slots
+	 */
+	std::size_t get_size() const;
+
+private: /* PRIVATE TYPES */
+
+	// a free slot holds the next free one
+	struct FreeSlot
+	{
+		FreeSlot* next;
+	};
+
+private: /* PRIVATE VARS */
+	const std::size_t slot_size;
+	const std::size_t slots_per_chunk;
+
+	std::vector<std::unique_ptr<std::max_align_t[]>> chunks;
+
+	// slots that were never used, in chunks[chunk] from slot on
+	std::size_t chunk = 0;
+	std::size_t slot = 0;
+
+	FreeSlot* free_list = nullptr;
+	std::size_t size = 0;
+};
\ No newline at end of file
@@ -0,0 +1,93 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Contiguous structure-of-arrays storage of the physics state of all bodies.
+ * 		Each body is one index into all arrays, GameObject's only keep that index.
+ * 		Kernels stream through the arrays instead of chasing GameObject pointers.
+ */
+struct ParticleStore
+{
+	/**
+	 * @brief Append a new particle with all fields set to 0
+	 * @return The index of the new particle
+	 */
+	std::size_t add();
+
+	/**
+	 * @brief Remove a particle by moving the last one into its place
+	 * @param index The index of the particle
+	 */
+	void remove(const std::size_t index);
+
+	/**
+	 * @brief Get the number of particles
+	 * @return The number of particles
+	 */
+	std::size_t size() const;
+
+	/**
+	 * @brief Remove all particles
+	 */
+	void clear();
+
+	// position in m
+	std::vector<float> pos_x, pos_y;
+
+	// position before the last step of a frame, to draw in between steps, see World::keep_positions
+	std::vector<float> prev_pos_x, prev_pos_y;
+
+	// velocity in m/s
+	std::vector<float> vel_x, vel_y;
+
+	// acceleration in m/s^2, written by the force calculation, read by the integration
+	std::vector<float> acc_x, acc_y;
+
+	// mass in kg
+	std::vector<float> mass;
+
+	// radius in m
+	std::vector<float> radius;
+
+	// time-step level of BlockIntegrator, the step of a body is 2^level times shorter than the World step;
+	// UINT8_MAX until the integrator knows the body
+	std::vector<std::uint8_t> step_level;
+
+	// not used by the physics
+	// density in kg / m^3, color as sf::Color::toInteger
+	std::vector<float> density;
+	std::vector<std::uint32_t> color;
+
+	// false once positions or masses changed after the accelerations were calculated
+	bool acc_valid = false;
+};
\ No newline at end of file
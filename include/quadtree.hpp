@@ -0,0 +1,126 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "sfml.hpp"
+
+/**
+ * @brief Barnes-Hut quadtree used to approximate gravity in O(N log N).
+ * 		The tree is rebuilt every step from the body positions and masses, or refit between them,
+ * 		far away groups of bodies are treated as one body at their center of mass.
+ */
+class QuadTree
+{
+public: /* PUBLIC TYPES */
+
+	/**
+	 * @brief One square cell of the tree.
+	 * 		Leafs reference a range of bodies, inner nodes reference 4 children.
+	 */
+	struct Node
+	{
+		float center_x, center_y, half_size;
+		float mass, com_x, com_y;
+
+		// index of the first of 4 consecutive children, 0 for leafs
+		std::uint32_t first_child;
+
+		// range of the bodies in this cell, in QuadTree::indices
+		std::uint32_t begin, end;
+	};
+
+public: /* PUBLIC FUNCS */
+
+	/**
+	 * @brief Rebuild the tree from the bodies.
+	 * 		The arrays must stay valid until the next call to build.
+	 * @param pos_x The positions on the x axis
+	 * @param pos_y The positions on the y axis
+	 * @param mass The masses in kg
+	 * @param count The number of bodies
+	 */
+	void build(const float* pos_x, const float* pos_y, const float* mass, const std::size_t count);
+
+	/**
+	 * @brief Update the masses and centers of mass of all cells after the bodies moved, in O(N).
+	 * 		The cells keep their bodies and their size, so the tree gets less accurate
+	 * 		the further the bodies move, call build again once in a while.
+	 */
+	void refit();
+
+	/**
+	 * @brief Calculate the gravitational acceleration at the position of a body.
+	 * 		A cell is used as a whole if size / distance < theta, else it is opened.
+	 * @param G The gravitational constant in m^3 / (kg * s^2)
+	 * @param theta The opening angle, 0 is an exact direct sum
+	 * @param eps_sq The squared softening length in m^2
+	 * @param index The index of the body, it is skipped in the sum
+	 * @return The acceleration in m/s^2
+	 */
+	sf::Vector2f calc_acceleration(const float G, const float theta, const float eps_sq,
+		const std::size_t index) const;
+
+	/**
+	 * @brief Get all nodes of the tree, nodes[0] is the root
+	 * @return The nodes
+	 */
+	const std::vector<Node>& get_nodes() const;
+
+	/**
+	 * @brief Get the body indices sorted by cell, a Node references them with begin and end
+	 * @return The indices
+	 */
+	const std::vector<std::uint32_t>& get_indices() const;
+
+private: /* PRIVATE FUNCS */
+
+	/**
+	 * @brief Split a node into 4 children until it holds few enough bodies
+	 * @param node The index of the node
+	 * @param depth The depth of the node, the root has depth 0
+	 */
+	void subdivide(const std::uint32_t node, const unsigned int depth);
+
+private: /* PRIVATE VARS */
+
+	// a leaf holds at most this many bodies, they are summed directly
+	static constexpr std::uint32_t leaf_capacity = 8;
+
+	// cells are not split any further, guards against bodies at the same position
+	static constexpr unsigned int max_depth = 32;
+
+	std::vector<Node> nodes;
+	std::vector<std::uint32_t> indices;
+
+	const float* pos_x = nullptr;
+	const float* pos_y = nullptr;
+	const float* mass = nullptr;
+};
\ No newline at end of file
@@ -0,0 +1,143 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "particle_store.hpp"
+#include "trajectory.hpp"
+
+/**
+ * @brief Records every Nth step of a run into a Trajectory file.
+ * 		The simulation thread only copies the positions, velocities, radii and colors into one of a few
+ * 		preallocated buffers, a background thread compresses and writes them.
+ * 		If the writer falls behind and all buffers are full, frames are dropped instead of waiting.
+ */
+class Recorder
+{
+public: /* PUBLIC FUNCS */
+
+	/**
+	 * @brief Stop recording
+	 */
+	~Recorder();
+
+	/**
+	 * @brief Create the file and start the writer thread
+	 * @param filename The filename of the recording
+	 * @param every Record a frame every this many steps
+	 * @return False if the file couldn't be created
+	 */
+	bool open(const std::string filename, const unsigned int every);
+
+	/**
+	 * @brief Write all buffered frames and the index, then stop the writer thread
+	 */
+	void close();
+
+	/**
+	 * @brief Call after every step, copies the state if this step is recorded
+	 * @param particles The ParticleStore of the World
+	 * @param time The simulated time in s
+	 */
+	void record(const ParticleStore& particles, const double time);
+
+	/**
+	 * @brief Check if a recording is open
+	 * @return True if open
+	 */
+	bool is_open() const;
+
+	/**
+	 * @brief Get the number of frames dropped because the writer was too slow
+	 * @return The number of frames
+	 */
+	std::uint64_t get_dropped() const;
+
+private: /* PRIVATE TYPES */
+
+	struct Buffer
+	{
+		std::uint64_t step;
+		double time;
+		std::vector<float> pos_x, pos_y, vel_x, vel_y;
+		std::vector<float> radius;
+		std::vector<std::uint32_t> color;
+	};
+
+private: /* PRIVATE FUNCS */
+
+	/**
+	 * @brief Main loop of the writer thread
+	 */
+	void run();
+
+	/**
+	 * @brief Compress a frame and append it to the file, writer thread only
+	 * @param buffer The Buffer holding the frame
+	 */
+	void write_frame(const Buffer& buffer);
+
+private: /* PRIVATE VARS */
+	static constexpr std::size_t buffer_count = 8;
+
+	std::array<Buffer, buffer_count> buffers;
+
+	// indices into buffers, free ones for the simulation thread, full ones for the writer
+	std::vector<std::size_t> free_buffers;
+	std::deque<std::size_t> full_buffers;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::thread thread;
+	bool quit = false;
+
+	unsigned int every = 1;
+	std::uint64_t step = 0;
+	std::uint64_t dropped = 0;
+
+	// writer thread only
+	std::ofstream file;
+	std::vector<std::uint64_t> offsets;
+	std::vector<float> last[4], before[4];
+	std::vector<float> prediction;
+
+	// radius and color of the last key frame, the frames after it reuse them
+	std::vector<float> key_radius;
+	std::vector<std::uint32_t> key_color;
+	std::size_t since_key = 0;
+	std::vector<std::uint8_t> encoded;
+};
\ No newline at end of file
@@ -0,0 +1,105 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include "sfml.hpp"
+#include "snapshot.hpp"
+
+/**
+ * @brief Draws the bodies of a Snapshot, it owns all render state.
+ * 		How a body is drawn depends on its size on screen:
+ * 		below a pixel it is a point, added up with the others like a density map,
+ * 		up to large_radius pixels it is a quad with a shared circle texture,
+ * 		above that it is a polygon with as many segments as its size needs.
+ * 		All bodies go out in two draw calls, one for the points and one for the rest.
+ * 		Bodies outside of the view are culled with the tree of the Snapshot first.
+ */
+class Renderer
+{
+public: /* PUBLIC FUNCS */
+
+	/**
+	 * @brief Build the vertices of all bodies of a Snapshot
+	 * @param snapshot The Snapshot
+	 * @param alpha Where to draw between the previous (0) and the current (1) positions
+	 * @param pixels_per_unit The zoom of the camera, the size of one world unit in pixels
+	 * @param view The part of the world that is on screen, bodies outside are skipped
+	 */
+	void prepare(const Snapshot& snapshot, const float alpha, const float pixels_per_unit, const sf::FloatRect& view);
+
+	/**
+	 * @brief Draw all bodies of a Snapshot
+	 * @param window The sf::RenderWindow to draw to
+	 * @param snapshot The Snapshot
+	 * @param alpha Where to draw between the previous (0) and the current (1) positions
+	 */
+	void draw(sf::RenderWindow& window, const Snapshot& snapshot, const float alpha);
+
+	/**
+	 * @return The number of vertices built by the last prepare
+	 */
+	std::size_t get_vertex_count() const;
+
+private: /* PRIVATE FUNCS */
+
+	/**
+	 * @brief Render the circle all quads share, needs an OpenGL context
+	 */
+	void create_texture();
+
+	/**
+	 * @brief Add a body as a quad with the circle texture
+	 */
+	void add_quad(const float x, const float y, const float radius, const sf::Color color);
+
+	/**
+	 * @brief Add a body as a polygon
+	 * @param segments The number of corners
+	 */
+	void add_polygon(const float x, const float y, const float radius, const sf::Color color, const unsigned int segments);
+
+private: /* PRIVATE VARS */
+	static constexpr unsigned int texture_size = 256;
+
+	// radii on screen in pixels where the next level of detail starts
+	static constexpr float point_radius = 1.0f;
+	static constexpr float large_radius = 64.0f;
+
+	// one polygon segment per this many pixels of circumference
+	static constexpr float segment_length = 8.0f;
+	static constexpr unsigned int max_segments = 256;
+
+	// quads and polygons, both textured, polygons only use the opaque center of the texture
+	sf::VertexArray triangles = sf::VertexArray(sf::Triangles);
+	sf::VertexArray points = sf::VertexArray(sf::Points);
+
+	// the bodies left after culling
+	std::vector<std::uint32_t> visible;
+	sf::Texture texture;
+	bool texture_created = false;
+};
\ No newline at end of file
@@ -0,0 +1,175 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "trajectory.hpp"
+#include "snapshot.hpp"
+
+/**
+ * @brief Plays a recorded Trajectory in place of the Simulation.
+ * 		A worker thread decodes the frame being shown and the next few ahead of it into a
+ * 		small cache, the render thread turns two cached frames into a Snapshot for the Renderer.
+ * 		While a frame after a seek is not decoded yet, the last Snapshot stays on screen.
+ */
+class Replay
+{
+public: /* PUBLIC FUNCS */
+
+	/**
+	 * @brief Stop the worker thread and close the file
+	 */
+	~Replay();
+
+	/**
+	 * @brief Open a recording and start the worker thread, playback starts paused at the first frame
+	 * @param filename The filename of the recording
+	 * @return False if the file is no recording or has no frames
+	 */
+	bool open(const std::string filename);
+
+	/**
+	 * @brief Stop the worker thread and close the file
+	 */
+	void close();
+
+	/**
+	 * @brief Check if a recording is open
+	 * @return True if open
+	 */
+	bool is_open() const;
+
+	/**
+	 * @brief Advance the position while playing, render thread only
+	 * @param time The real time in s since the last call
+	 */
+	void update(const float time);
+
+	/**
+	 * @brief Get a Snapshot at the current position, render thread only.
+	 * 		The reference stays valid until the next call.
+	 * @param alpha Gets where to draw between the two frames of the Snapshot
+	 * @return The Snapshot, nullptr before the first frame is decoded
+	 */
+	const Snapshot* get_snapshot(float& alpha);
+
+	/**
+	 * @brief Get the number of frames
+	 * @return The number of frames
+	 */
+	std::size_t get_frame_count() const;
+
+	/**
+	 * @brief Jump to a position
+	 * @param position The position in frames, may be between two frames
+	 */
+	void set_position(const double position);
+
+	/**
+	 * @brief Get the position
+	 * @return The position in frames
+	 */
+	double get_position() const;
+
+	/**
+	 * @brief Play or pause
+	 * @param playing False to pause
+	 */
+	void set_playing(const bool playing);
+
+	/**
+	 * @brief Check if playing
+	 * @return False if paused
+	 */
+	bool is_playing() const;
+
+	/**
+	 * @brief Set how fast to play
+	 * @param speed The speed in frames per second
+	 */
+	void set_speed(const float speed);
+
+	/**
+	 * @brief Get how fast to play
+	 * @return The speed in frames per second
+	 */
+	float get_speed() const;
+
+private: /* PRIVATE TYPES */
+
+	struct Slot
+	{
+		std::size_t index = SIZE_MAX;
+		Trajectory::Frame frame;
+	};
+
+private: /* PRIVATE FUNCS */
+
+	/**
+	 * @brief Main loop of the worker thread
+	 */
+	void run();
+
+	/**
+	 * @brief Find a frame in the cache, the mutex must be locked
+	 * @return The Slot, nullptr if the frame is not decoded
+	 */
+	const Slot* find(const std::size_t index) const;
+
+private: /* PRIVATE VARS */
+
+	// the shown frame and the ones after it are decoded ahead
+	static constexpr std::size_t cache_size = 16;
+	static constexpr std::size_t read_ahead = 8;
+
+	Trajectory trajectory;
+	std::size_t frame_count = 0;
+
+	std::array<Slot, cache_size> cache;
+	std::size_t wanted = 0;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::thread thread;
+	bool quit = false;
+
+	// render thread only
+	double position = 0.0;
+	bool playing = false;
+	float speed = 30.0f;
+
+	Snapshot snapshot;
+	std::size_t shown_first = SIZE_MAX, shown_second = SIZE_MAX;
+	bool has_snapshot = false;
+};
\ No newline at end of file
@@ -0,0 +1,76 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "world.hpp"
+
+/**
+ * @brief Fills a World with reproducible sets of bodies, e.g. for headless runs and benchmarks
+ */
+class Scenario
+{
+public: /* PUBLIC TYPES */
+
+	enum class Type
+	{
+		random,	// bodies at rest, spread evenly over a square
+		disk	// a heavy star with bodies on circular orbits around it
+	};
+
+public: /* PUBLIC FUNCS */
+
+	/**
+	 * @brief Spawn the bodies of a scenario
+	 * @param world The World to spawn into
+	 * @param type The Scenario::Type
+	 * @param count The number of bodies, including the star of a disk
+	 * @param seed The seed of the random number generator, same seed means same bodies
+	 * @param size Half the width of the square, or the radius of the disk in m
+	 */
+	static void create(World& world, const Type type, const std::size_t count,
+		const unsigned int seed, const float size);
+
+	/**
+	 * @brief Spawn the bodies described by a scenario file.
+	 * 		The file has a "scenario" section with type, bodies, seed and size
+	 * @param world The World to spawn into
+	 * @param filename The filename of the scenario file
+	 * @return False if the file couldn't be loaded
+	 */
+	static bool load(World& world, const std::string filename);
+
+	/**
+	 * @brief Get the name of a scenario type
+	 * @param type The Scenario::Type
+	 * @return The name, e.g. "disk"
+	 */
+	static const char* get_name(const Type type);
+};
\ No newline at end of file
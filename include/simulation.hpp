@@ -0,0 +1,182 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "world.hpp"
+#include "snapshot.hpp"
+#include "triple_buffer.hpp"
+#include "recorder.hpp"
+
+/**
+ * @brief Steps a World on its own thread in fixed time steps.
+ * 		Other threads never touch the World while it runs, they read Snapshot's
+ * 		and change the World by pushing commands, which run between two steps.
+ */
+class Simulation
+{
+public: /* PUBLIC TYPES */
+
+	/**
+	 * @brief A change to the World, runs on the simulation thread
+	 */
+	typedef std::function<void(World&)> Command;
+
+public: /* PUBLIC FUNCS */
+
+	/**
+	 * @brief Constructor, the thread is not started yet
+	 * @param world The World to simulate, must outlive the Simulation
+	 */
+	Simulation(World& world);
+
+	/**
+	 * @brief Stop the thread
+	 */
+	~Simulation();
+
+	/**
+	 * @brief Start the simulation thread, the World must not be used directly afterwards
+	 */
+	void start();
+
+	/**
+	 * @brief Stop and join the simulation thread
+	 */
+	void stop();
+
+	/**
+	 * @brief Queue a change to the World, it runs before the next step
+	 * @param command The Simulation::Command
+	 */
+	void push(const Command command);
+
+	/**
+	 * @brief Pause or continue the simulation
+	 * @param running False to pause
+	 */
+	void set_running(const bool running);
+
+	/**
+	 * @brief Check if the simulation is running
+	 * @return False if paused
+	 */
+	bool is_running() const;
+
+	/**
+	 * @brief Set the fixed time step of the physics, the longest one with an adaptive time step
+	 * @param time_step The time step in s
+	 */
+	void set_time_step(const float time_step);
+
+	/**
+	 * @brief Get the fixed time step of the physics
+	 * @return The time step in s
+	 */
+	float get_time_step() const;
+
+	/**
+	 * @brief Set the number of steps after which the simulation gives up catching up with real time
+	 * @param max_substeps The number of steps
+	 */
+	void set_max_substeps(const unsigned int max_substeps);
+
+	/**
+	 * @brief Get the newest Snapshot of the World, only call this from one thread.
+	 * 		The reference stays valid until the next call.
+	 * @return The Snapshot
+	 */
+	const Snapshot& get_snapshot();
+
+	/**
+	 * @brief Queue saving the World and the simulated time to a Checkpoint file
+	 * @param filename The filename of the checkpoint
+	 */
+	void save_checkpoint(const std::string filename);
+
+	/**
+	 * @brief Queue replacing the World and the simulated time with a Checkpoint file
+	 * @param filename The filename of the checkpoint
+	 */
+	void load_checkpoint(const std::string filename);
+
+	/**
+	 * @brief Queue starting to record every Nth step into a Trajectory file
+	 * @param filename The filename of the recording
+	 * @param every Record a frame every this many steps
+	 */
+	void start_recording(const std::string filename, const unsigned int every);
+
+	/**
+	 * @brief Queue finishing the recording
+	 */
+	void stop_recording();
+
+private: /* PRIVATE FUNCS */
+
+	/**
+	 * @brief Main loop of the simulation thread
+	 */
+	void run();
+
+	/**
+	 * @brief Run all queued commands
+	 * @return True if there were any
+	 */
+	bool execute_commands();
+
+	/**
+	 * @brief Copy the World into the back Snapshot and publish it
+	 * @param lag The time in s since the last step
+	 */
+	void publish(const float lag);
+
+private: /* PRIVATE VARS */
+	World& world;
+	std::thread thread;
+
+	std::atomic<bool> quit{false};
+	std::atomic<bool> running{false};
+	std::atomic<float> time_step{0.01f};
+	std::atomic<unsigned int> max_substeps{8};
+
+	std::mutex command_mutex;
+	std::vector<Command> commands;
+
+	TripleBuffer<Snapshot> snapshots;
+	double time = 0.0;
+
+	// simulation thread only
+	Recorder recorder;
+};
\ No newline at end of file
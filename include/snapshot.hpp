@@ -0,0 +1,111 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "sfml.hpp"
+#include "world.hpp"
+#include "integrator.hpp"
+#include "quadtree.hpp"
+#include "handle.hpp"
+
+/**
+ * @brief A copy of everything the renderer and the ui need from the World.
+ * 		Written by the simulation thread, read by the render thread.
+ */
+struct Snapshot
+{
+	/**
+	 * @brief Copy the state of a World into the Snapshot, reusing the memory of the last one
+	 * @param world The World
+	 * @param time The simulated time in s
+	 * @param lag The time in s since the last step
+	 */
+	void capture(const World& world, const double time, const float lag);
+
+	/**
+	 * @brief Find all bodies that may overlap a rectangle at any point between the last two states.
+	 * 		Uses the Barnes-Hut tree if the World had one, O(visible + log N), else tests every body.
+	 * @param rect The rectangle in world coordinates
+	 * @param visible Gets the indices of the bodies, cleared first
+	 */
+	void find_visible(const sf::FloatRect& rect, std::vector<std::uint32_t>& visible) const;
+
+	/**
+	 * @brief Find a body by its Handle in O(1)
+	 * @param handle The Handle
+	 * @return The index of the body, empty if it doesn't exist in this Snapshot
+	 */
+	std::optional<std::size_t> find(const Handle handle) const;
+
+	// the last two states of every body, the renderer draws in between
+	std::vector<float> pos_x, pos_y;
+	std::vector<float> prev_pos_x, prev_pos_y;
+
+	std::vector<float> vel_x, vel_y;
+	std::vector<float> radius, density;
+	std::vector<std::uint32_t> color;
+	std::vector<std::string> name;
+
+	// the Handle of every body, and the body of every Handle::index, Handle::invalid for none
+	std::vector<Handle> handles;
+	std::vector<std::uint32_t> handle_bodies;
+
+	// the Barnes-Hut tree of the current positions, shared with the World;
+	// how far a body reaches out of its cell, its radius and the last step,
+	// bodies larger than large_radius are tested on their own to keep it tight
+	std::shared_ptr<const QuadTree> tree;
+	float margin = 0.0f;
+	float large_radius = 0.0f;
+	std::vector<std::uint32_t> large;
+
+	// World settings, for the ui
+	World::Solver solver = World::Solver::barnes_hut;
+	Integrator::Type integrator = Integrator::Type::leapfrog;
+	float theta = 0.0f, softening = 0.0f;
+	bool collisions = false;
+	float tolerance = 0.0f;
+	unsigned int threads = 1;
+
+	// whether a recording is open, set by the Simulation since the World doesn't know it
+	bool recording = false;
+
+	// simulated time in s, length of the last step in s
+	double time = 0.0;
+	float step = 0.0f;
+
+	// when the snapshot was taken, and the time in s since the last step back then
+	std::chrono::steady_clock::time_point taken;
+	float lag = 0.0f;
+};
\ No newline at end of file
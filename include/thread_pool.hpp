@@ -0,0 +1,103 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A fixed set of worker threads, created once and reused for every parallel_for.
+ * 		The calling thread works on the chunks as well.
+ */
+class ThreadPool
+{
+public: /* PUBLIC FUNCS */
+
+	/**
+	 * @brief Start the worker threads
+	 * @param threads The number of threads including the calling thread, 0 uses all cores
+	 */
+	ThreadPool(const unsigned int threads);
+
+	/**
+	 * @brief Stop and join the worker threads
+	 */
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/**
+	 * @brief Call func(begin, end) for chunks of [0, count) on all threads, returns once all chunks are done.
+	 * 		Chunk borders are multiples of align, so the split doesn't change which indices share a chunk border.
+	 * @param count The number of indices
+	 * @param align The chunk size is a multiple of this
+	 * @param func The function to call for every chunk
+	 */
+	void parallel_for(const std::size_t count, const std::size_t align,
+		const std::function<void(std::size_t, std::size_t)>& func);
+
+	/**
+	 * @brief Get the number of threads including the calling thread
+	 * @return The number of threads
+	 */
+	unsigned int get_size() const;
+
+private: /* PRIVATE FUNCS */
+
+	/**
+	 * @brief Main loop of a worker thread, waits for jobs
+	 */
+	void work();
+
+	/**
+	 * @brief Take chunks of the current job until there are none left
+	 */
+	void run_chunks();
+
+private: /* PRIVATE VARS */
+	std::vector<std::thread> workers;
+
+	std::mutex mutex;
+	std::condition_variable start_cond, done_cond;
+
+	// the current job
+	const std::function<void(std::size_t, std::size_t)>* job = nullptr;
+	std::size_t job_count = 0, job_chunk = 0;
+	std::atomic<std::size_t> next_chunk{0};
+
+	// incremented for every job, so workers know when to start
+	unsigned long generation = 0;
+	unsigned int pending = 0;
+	bool stop = false;
+};
\ No newline at end of file
@@ -0,0 +1,208 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The file format of recorded runs, written by the Recorder and read by the Replay.
+ * 		A Trajectory::Header, then frames, each a Trajectory::FrameHeader and the compressed arrays
+ * 		pos_x, pos_y, vel_x, vel_y, and on key frames also radius and color. After the last frame
+ * 		the offsets of all frames and a Trajectory::Trailer, so any frame can be found without
+ * 		reading the ones before. All values are little-endian.
+ *
+ * 		An array is stored as the XOR of its bits with a prediction from the frames before,
+ * 		split into 4 planes of bytes, with runs of zero bytes shortened to a 0 and their length.
+ * 		The prediction continues the change between the last two frames, or repeats the last frame
+ * 		right after a key frame. Bodies move smoothly, so most high bytes are 0.
+ * 		Key frames are XOR'ed with 0, they start every key_interval frames and whenever
+ * 		the number of bodies, a radius or a color changes.
+ *
+ * 		Reading maps the whole file into memory, so seeking costs no more than decoding
+ * 		from the last key frame, no matter how large the file is.
+ */
+class Trajectory
+{
+public: /* PUBLIC TYPES */
+
+	struct Header
+	{
+		char magic[8];			// "SOLYSTRJ"
+		std::uint32_t version;	// Trajectory::version
+		std::uint32_t every;	// steps between two frames
+	};
+
+	struct FrameHeader
+	{
+		std::uint64_t step;			// number of steps since the recording started
+		double time;				// simulated time in s
+		std::uint32_t count;		// number of bodies
+		std::uint32_t flags;		// Trajectory::key_frame
+		std::uint32_t size[6];		// compressed size of pos_x, pos_y, vel_x, vel_y, radius, color in bytes
+	};
+
+	struct Trailer
+	{
+		std::uint64_t frames;		// number of frames
+		std::uint64_t index;		// file offset of the frame offsets
+		char magic[8];				// "SOLYSIDX"
+	};
+
+	/**
+	 * @brief One decoded frame
+	 */
+	struct Frame
+	{
+		std::uint64_t step = 0;
+		double time = 0.0;
+		std::vector<float> pos_x, pos_y, vel_x, vel_y;
+
+		// only stored in key frames, the others have the ones of the key frame before
+		std::vector<float> radius;
+		std::vector<std::uint32_t> color;
+	};
+
+public: /* PUBLIC FUNCS */
+
+	/**
+	 * @brief Constructor, no file is open yet
+	 */
+	Trajectory() = default;
+
+	Trajectory(const Trajectory&) = delete;
+	Trajectory& operator=(const Trajectory&) = delete;
+
+	/**
+	 * @brief Unmap the file
+	 */
+	~Trajectory();
+
+	/**
+	 * @brief Predict an array from the frames before
+	 * @param last The array of the last frame
+	 * @param before The array of the frame before the last one
+	 * @param since_key The number of frames since the last key frame, 0 for key frames
+	 * @param count The number of values
+	 * @param prediction Gets the prediction
+	 */
+	static void predict(const std::vector<float>& last, const std::vector<float>& before,
+		const std::size_t since_key, const std::size_t count, std::vector<float>& prediction);
+
+	/**
+	 * @brief Compress an array of 4 byte values against its prediction
+	 * @param data The array
+	 * @param prediction The prediction of the array, nullptr for 0
+	 * @param count The number of values
+	 * @param out Gets the compressed bytes appended
+	 */
+	static void encode(const void* data, const void* prediction, const std::size_t count,
+		std::vector<std::uint8_t>& out);
+
+	/**
+	 * @brief Decompress an array of 4 byte values
+	 * @param in The compressed bytes
+	 * @param size The number of compressed bytes
+	 * @param data Holds the prediction of the array and gets the array,
+	 * 		nullptr to only check that the bytes hold count values
+	 * @param count The number of values
+	 * @return False if the bytes are broken
+	 */
+	static bool decode(const std::uint8_t* in, const std::size_t size, void* data, const std::size_t count);
+
+	/**
+	 * @brief Open a recording to read frames
+	 * @param filename The filename of the recording
+	 * @return False if the file couldn't be read or is no recording of this version
+	 */
+	bool open(const std::string filename);
+
+	/**
+	 * @brief Unmap the file
+	 */
+	void close();
+
+	/**
+	 * @brief Get the number of frames, a recording cut off by a crash has all complete ones
+	 * @return The number of frames
+	 */
+	std::size_t get_frame_count() const;
+
+	/**
+	 * @brief Get the number of steps between two frames
+	 * @return The number of steps
+	 */
+	unsigned int get_every() const;
+
+	/**
+	 * @brief Decode a frame, reading forward from the last key frame.
+	 * 		Reading the frames in order only decodes each one once.
+	 * @param index The index of the frame
+	 * @param frame Gets the frame
+	 * @return False if the index is out of range or the file is broken
+	 */
+	bool read_frame(const std::size_t index, Frame& frame);
+
+public: /* PUBLIC VARS */
+	static constexpr std::uint32_t version = 2;
+	static constexpr std::uint32_t key_frame = 1;
+	static constexpr std::uint32_t key_interval = 32;
+
+private: /* PRIVATE FUNCS */
+
+	/**
+	 * @brief Read the header of a frame
+	 */
+	FrameHeader read_frame_header(const std::size_t index) const;
+
+	/**
+	 * @brief Decode a frame onto the arrays in current
+	 */
+	bool decode_frame(const std::size_t index);
+
+	/**
+	 * @brief Get the file offset right after a frame, UINT64_MAX if its header isn't in the file
+	 */
+	std::uint64_t get_frame_end(const std::size_t index) const;
+
+private: /* PRIVATE VARS */
+	const std::uint8_t* data = nullptr;
+	std::size_t size = 0;
+	unsigned int every = 1;
+
+	// file offset of every frame, each one is complete
+	std::vector<std::uint64_t> offsets;
+
+	// the last two decoded frames, frames are predicted from them
+	Frame current;
+	Frame before;
+	std::size_t current_index = SIZE_MAX;
+	std::size_t since_key = 0;
+	std::vector<float> prediction;
+};
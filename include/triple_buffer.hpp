@@ -0,0 +1,94 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+
+/**
+ * @brief Lock-free triple buffer for one writer and one reader thread.
+ * 		The writer fills the back buffer and publishes it, the reader always gets the newest
+ * 		published buffer. Neither ever waits for the other, old buffers are reused.
+ * @tparam T The buffer type
+ */
+template<typename T>
+class TripleBuffer
+{
+public: /* PUBLIC FUNCS */
+
+	/**
+	 * @brief Get the buffer to write to, writer thread only
+	 * @return The back buffer
+	 */
+	T& get_back();
+
+	/**
+	 * @brief Publish the back buffer, afterwards get_back returns another buffer. Writer thread only
+	 */
+	void publish();
+
+	/**
+	 * @brief Get the newest published buffer, reader thread only.
+	 * 		The reference stays valid until the next call to get_front.
+	 * @return The front buffer
+	 */
+	const T& get_front();
+
+private: /* PRIVATE VARS */
+
+	// set in middle if it holds a buffer the reader hasn't seen yet
+	static constexpr unsigned int fresh = 4;
+
+	T buffers[3];
+
+	unsigned int back = 0;
+	std::atomic<unsigned int> middle{1};
+	unsigned int front = 2;
+};
+
+template<typename T>
+T& TripleBuffer<T>::get_back()
+{
+	return buffers[back];
+}
+
+template<typename T>
+void TripleBuffer<T>::publish()
+{
+	back = middle.exchange(back | fresh, std::memory_order_acq_rel) & ~fresh;
+}
+
+template<typename T>
+const T& TripleBuffer<T>::get_front()
+{
+	if (middle.load(std::memory_order_relaxed) & fresh)
+	{
+		front = middle.exchange(front, std::memory_order_acq_rel) & ~fresh;
+	}
+
+	return buffers[front];
+}
\ No newline at end of file
@@ -27,36 +27,116 @@
 
 #pragma once
 
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "sfml.hpp"
+#include "particle_store.hpp"
 #include "game_object.hpp"
 #include "celestial_body.hpp"
+#include "quadtree.hpp"
+#include "thread_pool.hpp"
+#include "object_pool.hpp"
+#include "handle.hpp"
+#include "integrator.hpp"
+#include "collisions.hpp"
+#include "config.hpp"
 
 class World
 {
+public: /* PUBLIC TYPES */
+
+	/**
+	 * @brief The algorithm used to calculate gravity
+	 */
+	enum class Solver
+	{
+		direct,				// exact O(N^2) sum, vectorized, used as reference
+		direct_symmetric,	// exact sum visiting every pair once, half the interactions
+		barnes_hut			// O(N log N) approximation using a QuadTree
+	};
+
 public: /* PUBLIC FUNCS */
 	World(const float G);
 	~World();
 
 	/**
-	 * @brief Update the World
+	 * @brief Update the World, the Integrator moves the bodies.
+	 * 		All accelerations are calculated before any body is moved,
+	 * 		so the result doesn't depend on the order the bodies were spawned in.
 	 * @param clock the game timer
 	 */
 	void update(const float time);
 
 	/**
-	 * @brief Draw the Worl to an sf::RenderWindow
-	 * @param window The sf::RenderWindow to draw to
+	 * @brief Remember the current positions as the previous ones, the renderer draws in between.
+	 * 		Only needed before the last step of a frame, update doesn't do it.
 	 */
-	void draw(sf::RenderWindow& window);
+	void keep_positions();
 
 	/**
-	 * @brief "Spawn" a new GameObject in the world
-	 * @param obj The GameObject to be spawned
+	 * @brief Get the step the adaptive time step controller wants next, see set_tolerance
+	 * @param max_time The longest step allowed in s
+	 * @return The step in s, max_time if the controller is off
 	 */
-	void spawn(GameObject* obj);
+	float get_time_step(const float max_time) const;
+
+	/**
+	 * @brief Get the length of the last step
+	 * @return The step in s
+	 */
+	float get_last_step() const;
+
+	/**
+	 * @brief Delete all GameObject's and their particles
+	 */
+	void clear();
+
+	/**
+	 * @brief "Spawn" a new GameObject in the world, its particle is added to the ParticleStore
+	 * @tparam T The type of the GameObject
+	 * @param args The constructor arguments, without the ParticleStore
+	 * @return The new GameObject, owned by the World
+	 */
+	template<typename T, typename... Args>
+	T* spawn(Args&&... args);
+
+	/**
+	 * @brief Keep the default names of new GameObject's from repeating a name given elsewhere,
+	 * 		e.g. one loaded from a file. Only plain numbers can collide with them.
+	 * @param name The name
+	 */
+	void reserve_name(const std::string& name);
+
+	/**
+	 * @brief Calculate the accelerations of all particles with the current solver.
+	 * 		Only reads positions and masses, writes ParticleStore::acc_x and acc_y.
+	 */
+	void compute_accelerations();
+
+	/**
+	 * @brief Calculate the accelerations of some particles with the current solver,
+	 * 		the other accelerations stay as they are
+	 * @param active The indices of the particles
+	 */
+	void compute_accelerations(const std::vector<std::uint32_t>& active);
+
+	/**
+	 * @brief Load the "physics" settings and the number of threads from "advanced"
+	 * @param config The settings
+	 */
+	void load_settings(const Config& config);
+
+	/**
+	 * @brief Get the gravitational constant
+	 * @return G in m^3 / (kg * s^2)
+	 */
+	float get_G() const;
 
 	/**
 	 * @brief Get a copy of all game_objects
@@ -64,27 +144,262 @@ public: /* PUBLIC FUNCS */
 	 */
 	std::vector<GameObject*> get_objs() const;
 
+	/**
+	 * @brief Get a GameObject by the index of its particle
+	 * @param index The index in the ParticleStore
+	 * @return The GameObject
+	 */
+	GameObject* get_obj(const std::size_t index) const;
+
+	/**
+	 * @brief Get a GameObject by its Handle in O(1)
+	 * @param handle The Handle
+	 * @return The GameObject, nullptr if it was destroyed
+	 */
+	GameObject* get_obj(const Handle handle) const;
+
+	/**
+	 * @brief Get the Handle of a GameObject, it stays valid when other GameObject's are destroyed
+	 * @param index The index of its particle in the ParticleStore
+	 * @return The Handle
+	 */
+	Handle get_handle(const std::size_t index) const;
+
+	/**
+	 * @brief Find the particle of a GameObject in O(1)
+	 * @param handle The Handle
+	 * @return The index in the ParticleStore, empty if the GameObject was destroyed
+	 */
+	std::optional<std::size_t> find(const Handle handle) const;
+
+	/**
+	 * @brief Destroy a GameObject in O(1). The last GameObject and its particle move into its place,
+	 * 		so indices change, Handle's stay valid.
+	 * @param handle The Handle
+	 * @return False if it was already destroyed
+	 */
+	bool destroy(const Handle handle);
+
+	/**
+	 * @brief Get the physics state of all GameObject's
+	 * @return The ParticleStore
+	 */
+	const ParticleStore& get_particles() const;
+
+	/**
+	 * @brief Get the physics state of all GameObject's to change it directly, e.g. when loading
+	 * @return The ParticleStore
+	 */
+	ParticleStore& get_particles();
+
+	/**
+	 * @brief Get the Barnes-Hut tree of the current positions. It is never rebuilt while it is held,
+	 * 		so a Snapshot can share it instead of copying it.
+	 * @return The QuadTree, nullptr if the bodies changed since the last Barnes-Hut force calculation
+	 */
+	std::shared_ptr<const QuadTree> get_tree() const;
+
+	/**
+	 * @brief Get the name of a solver
+	 * @param solver The World::Solver
+	 * @return The name, e.g. "barnes-hut"
+	 */
+	static const char* get_solver_name(const Solver solver);
+
+	/**
+	 * @brief Set the algorithm used to calculate gravity
+	 * @param solver The World::Solver
+	 */
+	void set_solver(const Solver solver);
+
+	/**
+	 * @brief Get the algorithm used to calculate gravity
+	 * @return The World::Solver
+	 */
+	Solver get_solver() const;
+
+	/**
+	 * @brief Set the opening angle of the Barnes-Hut solver.
+	 * 		Smaller is more accurate but slower, 0 is the same as the direct sum.
+	 * @param theta The opening angle
+	 */
+	void set_theta(const float theta);
+
+	/**
+	 * @brief Get the opening angle of the Barnes-Hut solver
+	 * @return The opening angle
+	 */
+	float get_theta() const;
+
+	/**
+	 * @brief Set the softening length, it keeps close encounters from causing near infinite forces
+	 * @param softening The softening length in m, 0 for plain Newtonian gravity
+	 */
+	void set_softening(const float softening);
+
+	/**
+	 * @brief Get the softening length
+	 * @return The softening length in m
+	 */
+	float get_softening() const;
+
+	/**
+	 * @brief Set the integrator moving the bodies
+	 * @param type The Integrator::Type
+	 */
+	void set_integrator(const Integrator::Type type);
+
+	/**
+	 * @brief Get the integrator moving the bodies
+	 * @return The Integrator::Type
+	 */
+	Integrator::Type get_integrator() const;
+
+	/**
+	 * @brief Set whether overlapping bodies merge, mass and momentum are conserved
+	 * @param collisions True to merge bodies
+	 */
+	void set_collisions(const bool collisions);
+
+	/**
+	 * @brief Get whether overlapping bodies merge
+	 * @return True if bodies merge
+	 */
+	bool get_collisions() const;
+
+	/**
+	 * @brief Set the tolerance of the adaptive time step controller. The step is tolerance * |a| / |j|
+	 * 		of the body whose acceleration changes fastest, j is the change of a over the last step.
+	 * 		Yoshida and Wisdom-Holman don't leave valid accelerations, with them it costs
+	 * 		an extra force calculation per step.
+	 * @param tolerance The tolerance, 0 for fixed steps
+	 */
+	void set_tolerance(const float tolerance);
+
+	/**
+	 * @brief Get the tolerance of the adaptive time step controller
+	 * @return The tolerance, 0 for fixed steps
+	 */
+	float get_tolerance() const;
+
+	/**
+	 * @brief Set the number of threads calculating gravity, the results don't depend on it
+	 * @param threads The number of threads, 0 uses all cores
+	 */
+	void set_threads(const unsigned int threads);
+
+	/**
+	 * @brief Get the number of threads calculating gravity
+	 * @return The number of threads
+	 */
+	unsigned int get_threads() const;
+
 private: /* PRIVATE FUNCS */
 
-	// GAME OBJECT
-	//
 	/**
-	 * @brief Update a GameObject
-	 * @param clock The game timer
-	 * @param obj A reference to the GameObject
+	 * @brief Calculate the accelerations using the direct sum
 	 */
-	void update(const float time, GameObject* obj) const;
+	void compute_direct();
 
-	// CELESTIAL BODY
-	//
 	/**
-	 * @brief Update a CelestialBody
-	 * @param clock the game timer
-	 * @param obj The CelestialBody to update
+	 * @brief Calculate the accelerations using the symmetric pair sum
+	 */
+	void compute_direct_symmetric();
+
+	/**
+	 * @brief Calculate the accelerations using the Barnes-Hut solver
+	 */
+	void compute_barnes_hut();
+
+	/**
+	 * @brief Build the Barnes-Hut tree from the current positions
 	 */
-	void update(const float time, CelestialBody* obj) const;
+	void build_tree();
+
+	/**
+	 * @brief Estimate the next step from the accelerations before and after the last one
+	 * @param time The last step
+	 */
+	void estimate_time_step(const float time);
+
+	/**
+	 * @brief Merge all overlapping bodies, the lighter body of a pair is destroyed
+	 */
+	void resolve_collisions();
+
+	/**
+	 * @brief Add a constructed GameObject, give it a Handle and a name
+	 * @param obj The GameObject, its particle must be the last one
+	 */
+	void add_object(GameObject* obj);
+
+private: /* PRIVATE TYPES */
+
+	/**
+	 * @brief What a Handle::index refers to
+	 */
+	struct Slot
+	{
+		std::uint32_t object;		// index in objects, or the next free slot
+		std::uint32_t generation;	// increased every time the slot is freed
+	};
 
 private: /* PRIVATE VARS */
+
+	// every GameObject type must fit into a slot of object_pool
+	static constexpr std::size_t object_slot_size = 128;
+
+	ObjectPool object_pool = ObjectPool(object_slot_size);
+
+	// objects[i] owns particle i, object_slots[i] is the slot of its Handle
 	std::vector<GameObject*> objects;
+	std::vector<std::uint32_t> object_slots;
+	ParticleStore particles;
+
+	// slots of the Handle's, free ones form a list through Slot::object
+	std::vector<Slot> slots;
+	std::uint32_t free_slot = Handle::invalid;
+
+	// numbers the default names, never reused until the World is cleared
+	unsigned long next_id = 0;
 	float G;
-};
\ No newline at end of file
+
+	Solver solver = Solver::barnes_hut;
+	float theta = 0.5f;
+	float softening = 0.0f;
+
+	// the current tree, and older ones that were held by a Snapshot while the next was built
+	std::shared_ptr<QuadTree> tree = std::make_shared<QuadTree>();
+	std::vector<std::shared_ptr<QuadTree>> spare_trees;
+	bool tree_current = false;
+
+	// the bodies of a block substep gathered into contiguous arrays, to fill the vectors of the direct sum
+	std::vector<float> active_pos_x, active_pos_y, active_acc_x, active_acc_y;
+
+	std::unique_ptr<ThreadPool> pool;
+
+	Integrator::Type integrator_type = Integrator::Type::leapfrog;
+	std::unique_ptr<Integrator> integrator;
+
+	bool collisions = false;
+
+	// the step of the controller, 0 until it saw one step without the bodies changing;
+	// accelerations at the start of the last step
+	float tolerance = 0.0f;
+	float step_estimate = 0.0f;
+	float last_step = 0.0f;
+	std::vector<float> old_acc_x, old_acc_y;
+	Collisions broad_phase;
+	std::vector<Collisions::Pair> collision_pairs;
+};
+
+template<typename T, typename... Args>
+T* World::spawn(Args&&... args)
+{
+	static_assert(sizeof(T) <= object_slot_size, "GameObject type too large for World::object_pool");
+	static_assert(alignof(T) <= alignof(std::max_align_t), "GameObject type needs a larger alignment");
+
+	T* obj = new (object_pool.allocate()) T(particles, std::forward<Args>(args)...);
+	add_object(static_cast<GameObject*>(obj));
+	return obj;
+}
\ No newline at end of file
@@ -27,45 +27,29 @@
 
 #include "celestial_body.hpp"
 
-CelestialBody::CelestialBody(const float density, const float radius, const sf::Color color):
-	GameObject(Type::celestial_body),
-	density(density),
-	radius(radius)
+CelestialBody::CelestialBody(ParticleStore& particles, const float density, const float radius,
+	const sf::Color color):
+	GameObject(Type::celestial_body, particles)
 {
 	set_radius(radius);
 	set_color(color);
-	volume = calc_volume(radius);
-	mass = calc_mass(density, volume);
-
-	pos = sf::Vector2f(0.0f, 0.0f);
-	vel = sf::Vector2f(0.0f, 0.0f);
-}
-
-void CelestialBody::update(const float time)
-{
-	pos += vel * time;
-	shape.setPosition((float)pos.x, (float)pos.y);
+	set_density(density);
+	particles.mass[index] = calc_mass(density, calc_volume(radius));
 }
 
-void CelestialBody::draw(sf::RenderWindow& window)
-{
-	window.draw(shape);
-}
-
-void CelestialBody::set_origin(const float radius)
+void CelestialBody::set_radius(const float radius)
 {
-	shape.setOrigin(float(radius), float(radius));
+	particles.radius[index] = radius;
 }
 
-void CelestialBody::set_radius(const float radius)
+void CelestialBody::set_color(const sf::Color color)
 {
-	shape.setRadius(radius);
-	set_origin(radius);
+	particles.color[index] = color.toInteger();
 }
 
-void CelestialBody::set_color(const sf::Color color)
+sf::Color CelestialBody::get_color() const
 {
-	shape.setFillColor(color);
+	return sf::Color(particles.color[index]);
 }
 
 float CelestialBody::calc_mass(const float density, const float volume)
@@ -80,15 +64,15 @@ float CelestialBody::calc_volume(const float radius)
 
 float CelestialBody::get_radius() const
 {
-	return radius;
+	return particles.radius[index];
 }
 
 float CelestialBody::get_density() const
 {
-	return density;
+	return particles.density[index];
 }
 
 void CelestialBody::set_density(const float density)
 {
-	this->density = density;
+	particles.density[index] = density;
 }
\ No newline at end of file
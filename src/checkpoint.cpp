@@ -0,0 +1,218 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "checkpoint.hpp"
+#include "byte_order.hpp"
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+/* HELPERS */
+
+template<typename T>
+static void write_array(std::ofstream& file, const std::vector<T>& data)
+{
+	if constexpr (std::endian::native == std::endian::big)
+	{
+		std::vector<T> swapped = data;
+		to_little_endian(swapped.data(), swapped.size());
+		file.write(reinterpret_cast<const char*>(swapped.data()), swapped.size() * sizeof(T));
+	}
+	else
+	{
+		file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+	}
+}
+
+template<typename T>
+static bool read_array(std::ifstream& file, std::vector<T>& data, const std::size_t count)
+{
+	data.resize(count);
+	file.read(reinterpret_cast<char*>(data.data()), count * sizeof(T));
+	to_little_endian(data.data(), count);
+	return (bool)file;
+}
+
+static_assert(sizeof(Checkpoint::Header) == 32, "the header must not have padding");
+
+static const char magic[8] = { 'S', 'O', 'L', 'Y', 'S', 'C', 'H', 'K' };
+
+/* CHECKPOINT */
+
+bool Checkpoint::save(const World& world, const double time, const std::string filename)
+{
+	const ParticleStore& particles = world.get_particles();
+	const std::vector<GameObject*> objs = world.get_objs();
+
+	std::ofstream file(filename, std::ios::binary);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	Header header;
+	std::memcpy(header.magic, magic, sizeof(magic));
+	header.version = version;
+	header.flags = 0;
+	header.count = particles.size();
+	header.time = time;
+
+	to_little_endian(&header.version, 1);
+	to_little_endian(&header.flags, 1);
+	to_little_endian(&header.count, 1);
+	to_little_endian(&header.time, 1);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	write_array(file, particles.pos_x);
+	write_array(file, particles.pos_y);
+	write_array(file, particles.vel_x);
+	write_array(file, particles.vel_y);
+	write_array(file, particles.mass);
+	write_array(file, particles.radius);
+	write_array(file, particles.density);
+	write_array(file, particles.color);
+
+	// names in the order of the bodies, not of the objects
+	std::vector<std::string> names(particles.size());
+	for (const auto& obj: objs)
+	{
+		names[obj->get_index()] = obj->get_name();
+	}
+
+	std::vector<std::uint32_t> name_lengths;
+	std::string name_data;
+	for (const std::string& name: names)
+	{
+		name_lengths.push_back((std::uint32_t)name.size());
+		name_data += name;
+	}
+
+	write_array(file, name_lengths);
+	file.write(name_data.data(), name_data.size());
+
+	return (bool)file;
+}
+
+bool Checkpoint::load(World& world, double& time, const std::string filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	// the size of the file bounds everything read from it, so a broken count can't allocate too much
+	file.seekg(0, std::ios::end);
+	const std::uint64_t file_size = (std::uint64_t)file.tellg();
+	file.seekg(0, std::ios::beg);
+
+	Header header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	to_little_endian(&header.version, 1);
+	to_little_endian(&header.count, 1);
+	to_little_endian(&header.time, 1);
+
+	if (!file || std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version)
+	{
+		return false;
+	}
+
+	// positions, velocities, mass, radius, density, color and the length of the name
+	constexpr std::uint64_t bytes_per_body = 7 * sizeof(float) + 2 * sizeof(std::uint32_t);
+	const std::uint64_t body_bytes = file_size - sizeof(header);
+
+	if (file_size < sizeof(header) || header.count > body_bytes / bytes_per_body)
+	{
+		return false;
+	}
+
+	// read everything before touching the World, so a broken file changes nothing
+	const std::size_t count = header.count;
+	std::vector<float> pos_x, pos_y, vel_x, vel_y, mass, radius, density;
+	std::vector<std::uint32_t> color, name_lengths;
+
+	bool ok = read_array(file, pos_x, count) && read_array(file, pos_y, count)
+		&& read_array(file, vel_x, count) && read_array(file, vel_y, count)
+		&& read_array(file, mass, count) && read_array(file, radius, count)
+		&& read_array(file, density, count) && read_array(file, color, count)
+		&& read_array(file, name_lengths, count);
+
+	if (!ok)
+	{
+		return false;
+	}
+
+	std::size_t name_size = 0;
+	for (const std::uint32_t length: name_lengths)
+	{
+		name_size += length;
+	}
+
+	if (name_size > body_bytes - count * bytes_per_body)
+	{
+		return false;
+	}
+
+	std::string name_data(name_size, '\0');
+	if (!file.read(name_data.data(), name_size))
+	{
+		return false;
+	}
+
+	world.clear();
+
+	std::size_t name_offset = 0;
+	for (std::size_t i = 0; i < count; i++)
+	{
+		CelestialBody* body = world.spawn<CelestialBody>(density[i], radius[i]);
+		body->set_name(name_data.substr(name_offset, name_lengths[i]));
+		name_offset += name_lengths[i];
+	}
+
+	// spawning numbered the bodies up to the count, loaded numbers may go higher after merges
+	for (const auto& obj: world.get_objs())
+	{
+		world.reserve_name(obj->get_name());
+	}
+
+	// the bodies are in the store in the order they were spawned, so the arrays fit as a whole
+	ParticleStore& particles = world.get_particles();
+	particles.pos_x = pos_x;
+	particles.pos_y = pos_y;
+	particles.prev_pos_x = std::move(pos_x);
+	particles.prev_pos_y = std::move(pos_y);
+	particles.vel_x = std::move(vel_x);
+	particles.vel_y = std::move(vel_y);
+	particles.mass = std::move(mass);
+	particles.color = std::move(color);
+	particles.acc_valid = false;
+
+	time = header.time;
+	return true;
+}
\ No newline at end of file
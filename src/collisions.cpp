@@ -0,0 +1,203 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "collisions.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void Collisions::find(const ParticleStore& particles, std::vector<Pair>& pairs)
+{
+	const std::size_t count = particles.size();
+	pairs.clear();
+
+	if (count < 2)
+	{
+		return;
+	}
+
+	double radius_sum = 0.0;
+	for (const float r: particles.radius)
+	{
+		radius_sum += r;
+	}
+
+	cell_size = std::max(4.0f * (float)(radius_sum / count), 1e-3f);
+
+	// a power of two with at least 2 buckets per body, so few cells share one
+	std::uint32_t buckets = 1;
+	while (buckets < 2 * count)
+	{
+		buckets <<= 1;
+	}
+	mask = buckets - 1;
+
+	// sort the small bodies by bucket, counting sort
+	bucket_start.assign(buckets + 1, 0);
+	body_buckets.resize(count);
+	large.clear();
+
+	for (std::uint32_t i = 0; i < count; i++)
+	{
+		if (particles.radius[i] * 2.0f > cell_size)
+		{
+			large.push_back(i);
+			body_buckets[i] = UINT32_MAX;
+			continue;
+		}
+
+		body_buckets[i] = get_bucket(get_cell(particles.pos_x[i]), get_cell(particles.pos_y[i]));
+		bucket_start[body_buckets[i] + 1]++;
+	}
+
+	for (std::uint32_t b = 0; b < buckets; b++)
+	{
+		bucket_start[b + 1] += bucket_start[b];
+	}
+
+	bodies.resize(count - large.size());
+	std::vector<std::uint32_t> fill(bucket_start.begin(), bucket_start.end() - 1);
+	for (std::uint32_t i = 0; i < count; i++)
+	{
+		if (body_buckets[i] != UINT32_MAX)
+		{
+			bodies[fill[body_buckets[i]]++] = i;
+		}
+	}
+
+	// small bodies against the small bodies around them
+	for (std::uint32_t i = 0; i < count; i++)
+	{
+		if (body_buckets[i] == UINT32_MAX)
+		{
+			continue;
+		}
+
+		const std::int64_t cell_x = get_cell(particles.pos_x[i]);
+		const std::int64_t cell_y = get_cell(particles.pos_y[i]);
+
+		for (std::int64_t y = cell_y - 1; y <= cell_y + 1; y++)
+		{
+			for (std::int64_t x = cell_x - 1; x <= cell_x + 1; x++)
+			{
+				test_cell(particles, i, x, y, pairs);
+			}
+		}
+	}
+
+	// large bodies against the small bodies in every cell they touch, or all bodies if that is less work
+	for (const std::uint32_t i: large)
+	{
+		const float r = particles.radius[i] + cell_size * 0.5f;
+		const std::int64_t min_x = get_cell(particles.pos_x[i] - r), max_x = get_cell(particles.pos_x[i] + r);
+		const std::int64_t min_y = get_cell(particles.pos_y[i] - r), max_y = get_cell(particles.pos_y[i] + r);
+
+		if ((max_x - min_x + 1) * (max_y - min_y + 1) > (std::int64_t)count)
+		{
+			for (const std::uint32_t j: bodies)
+			{
+				const float d_x = particles.pos_x[j] - particles.pos_x[i];
+				const float d_y = particles.pos_y[j] - particles.pos_y[i];
+				const float r_sum = particles.radius[i] + particles.radius[j];
+
+				if (d_x * d_x + d_y * d_y < r_sum * r_sum)
+				{
+					pairs.emplace_back(std::min(i, j), std::max(i, j));
+				}
+			}
+		}
+		else
+		{
+			for (std::int64_t y = min_y; y <= max_y; y++)
+			{
+				for (std::int64_t x = min_x; x <= max_x; x++)
+				{
+					test_cell(particles, i, x, y, pairs);
+				}
+			}
+		}
+	}
+
+	// large bodies against each other, there are only a few
+	for (std::size_t a = 0; a < large.size(); a++)
+	{
+		for (std::size_t b = a + 1; b < large.size(); b++)
+		{
+			const std::uint32_t i = large[a], j = large[b];
+			const float d_x = particles.pos_x[j] - particles.pos_x[i];
+			const float d_y = particles.pos_y[j] - particles.pos_y[i];
+			const float r_sum = particles.radius[i] + particles.radius[j];
+
+			if (d_x * d_x + d_y * d_y < r_sum * r_sum)
+			{
+				pairs.emplace_back(std::min(i, j), std::max(i, j));
+			}
+		}
+	}
+
+	// cells sharing a bucket and large bodies covering a cell twice find the same pair more than once
+	std::sort(pairs.begin(), pairs.end());
+	pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+}
+
+std::int64_t Collisions::get_cell(const float x) const
+{
+	return (std::int64_t)std::floor(x / cell_size);
+}
+
+std::uint32_t Collisions::get_bucket(const std::int64_t cell_x, const std::int64_t cell_y) const
+{
+	const std::uint64_t hash = (std::uint64_t)cell_x * 73856093u ^ (std::uint64_t)cell_y * 19349663u;
+	return (std::uint32_t)(hash ^ (hash >> 32)) & mask;
+}
+
+void Collisions::test_cell(const ParticleStore& particles, const std::uint32_t index,
+	const std::int64_t cell_x, const std::int64_t cell_y, std::vector<Pair>& pairs) const
+{
+	const std::uint32_t bucket = get_bucket(cell_x, cell_y);
+	const bool is_large = body_buckets[index] == UINT32_MAX;
+
+	for (std::uint32_t k = bucket_start[bucket]; k < bucket_start[bucket + 1]; k++)
+	{
+		const std::uint32_t j = bodies[k];
+
+		// small pairs are found from both sides, keep one
+		if (!is_large && j <= index)
+		{
+			continue;
+		}
+
+		const float d_x = particles.pos_x[j] - particles.pos_x[index];
+		const float d_y = particles.pos_y[j] - particles.pos_y[index];
+		const float r_sum = particles.radius[index] + particles.radius[j];
+
+		if (d_x * d_x + d_y * d_y < r_sum * r_sum)
+		{
+			pairs.emplace_back(std::min(index, j), std::max(index, j));
+		}
+	}
+}
\ No newline at end of file
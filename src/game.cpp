@@ -48,6 +48,15 @@ bool Game::init(const Config& config)
 	camera_speed = config.get_value<float>("advanced", "camera-speed");
 	fast_camera_speed = config.get_value<float>("advanced", "fast-camera-speed");
 
+	// Load "physics" settings
+	world.load_settings(config);
+
+	const float time_step = config.get_value<float>("physics", "time-step");
+	simulation.set_time_step(time_step > 0.0f ? time_step : 1.0f / 120.0f);
+
+	const unsigned int max_substeps = config.get_value<unsigned int>("physics", "max-substeps");
+	simulation.set_max_substeps(max_substeps > 0 ? max_substeps : 8);
+
 	// create window
 	window.create(vmode, "Solys " + SOLYS_VERSION);
 
@@ -62,10 +71,13 @@ bool Game::init(const Config& config)
 	// init game variables
 	state = State::paused;
 
-	// init the game world
-	selected_obj = nullptr;
+	// init the game world, from now on only the simulation thread touches it
+	selected_obj.reset();
 
-	world.spawn(static_cast<GameObject*>(new CelestialBody(10.0f, 25.0f)));
+	world.spawn<CelestialBody>(10.0f, 25.0f);
+
+	simulation.set_running(false);
+	simulation.start();
 
 	return window.isOpen();
 }
@@ -79,27 +91,16 @@ void Game::run()
 
 		window.clear();
 
+		// the newest state of the world, the ui and the renderer both use this one
+		snapshot = &simulation.get_snapshot();
+
 		// Update ImGui
 		ImGui::SFML::Update(window, clock.getElapsedTime());
 
 		// draw gui
 		draw_ui();
 
-		switch (state)
-		{	
-			case State::playing:
-				world.update(clock.getElapsedTime().asSeconds());
-				draw_game_world();
-				break;
-
-			case State::paused:
-				world.update(0.0f);
-				draw_game_world();
-				break;
-
-			default:
-				break;
-		}
+		draw_game_world();
 
 		// Render ImGui
 		ImGui::SFML::Render(window);
@@ -116,13 +117,35 @@ void Game::run()
 			sf::sleep(sf::milliseconds((1.0f / framerate_limit) * 1000));
 		}
 	}
+
+	simulation.stop();
 }
 
 void Game::draw_game_world()
 {
 	window.setView(camera);
 
-	world.draw(window);
+	if (replay.is_open())
+	{
+		replay.update(clock.getElapsedTime().asSeconds());
+
+		float alpha;
+		const Snapshot* frame = replay.get_snapshot(alpha);
+		if (frame)
+		{
+			renderer.draw(window, *frame, alpha);
+		}
+
+		return;
+	}
+
+	// draw in between the last two steps, by how much time passed since the last one
+	const float since_taken = std::chrono::duration<float>(
+		std::chrono::steady_clock::now() - snapshot->taken).count();
+	const float step = snapshot->step > 0.0f ? snapshot->step : simulation.get_time_step();
+	const float alpha = std::min(1.0f, (snapshot->lag + since_taken) / step);
+
+	renderer.draw(window, *snapshot, alpha);
 }
 
 void Game::draw_ui()
@@ -132,13 +155,14 @@ void Game::draw_ui()
 
 	if (ImGui::BeginMainMenuBar())
 	{
-		// draw the play button depending on the state
-		switch (state)
+		// draw the play button depending on the state, a replay has its own
+		switch (replay.is_open() ? State::paused : state)
 		{
 			case State::playing:
 				if (ImGui::Button("II"))
 				{
 					state = State::paused;
+					simulation.set_running(false);
 				}
 				break;
 
@@ -146,6 +170,7 @@ void Game::draw_ui()
 				if (ImGui::Button("|>"))
 				{
 					state = State::playing;
+					simulation.set_running(true);
 				}
 				break;
 
@@ -155,10 +180,125 @@ void Game::draw_ui()
 
 		if (ImGui::Button("Add Planet"))
 		{
-			CelestialBody* cb = new CelestialBody(50.0f, 10.0f);
-			cb->set_pos(camera.getCenter());
+			const sf::Vector2f pos = camera.getCenter();
 
-			world.spawn(static_cast<GameObject*>(cb));
+			simulation.push([pos](World& world)
+			{
+				world.spawn<CelestialBody>(50.0f, 10.0f)->set_pos(pos);
+			});
+		}
+
+		if (ImGui::BeginMenu("File"))
+		{
+			if (ImGui::MenuItem("Save checkpoint"))
+			{
+				simulation.save_checkpoint(checkpoint_file);
+			}
+
+			if (ImGui::MenuItem("Load checkpoint"))
+			{
+				simulation.load_checkpoint(checkpoint_file);
+				selected_obj.reset();
+			}
+
+			ImGui::Separator();
+
+			// the recording may fail to open on the simulation thread, so show what it reports
+			if (ImGui::MenuItem("Record", nullptr, snapshot->recording))
+			{
+				if (snapshot->recording)
+				{
+					simulation.stop_recording();
+				}
+				else
+				{
+					simulation.start_recording(recording_file, record_every);
+				}
+			}
+
+			ImGui::Separator();
+
+			if (ImGui::MenuItem("Open replay", nullptr, replay.is_open()))
+			{
+				if (replay.is_open())
+				{
+					replay.close();
+				}
+				else if (replay.open(recording_file))
+				{
+					// the World waits while the recording is shown
+					state = State::paused;
+					simulation.set_running(false);
+					selected_obj.reset();
+				}
+			}
+
+			ImGui::EndMenu();
+		}
+
+		if (ImGui::BeginMenu("Physics"))
+		{
+			for (const auto solver: { World::Solver::barnes_hut, World::Solver::direct,
+				World::Solver::direct_symmetric })
+			{
+				if (ImGui::MenuItem(World::get_solver_name(solver), nullptr, snapshot->solver == solver))
+				{
+					simulation.push([solver](World& world) { world.set_solver(solver); });
+				}
+			}
+
+			float theta = snapshot->theta;
+			if (ImGui::SliderFloat("Theta", &theta, 0.0f, 1.5f))
+			{
+				simulation.push([theta](World& world) { world.set_theta(theta); });
+			}
+
+			float softening = snapshot->softening;
+			if (ImGui::SliderFloat("Softening", &softening, 0.0f, 50.0f))
+			{
+				simulation.push([softening](World& world) { world.set_softening(softening); });
+			}
+
+			if (ImGui::MenuItem("Collisions", nullptr, snapshot->collisions))
+			{
+				const bool collisions = !snapshot->collisions;
+				simulation.push([collisions](World& world) { world.set_collisions(collisions); });
+			}
+
+			ImGui::Separator();
+
+			for (const auto type: { Integrator::Type::euler, Integrator::Type::leapfrog,
+				Integrator::Type::velocity_verlet, Integrator::Type::yoshida, Integrator::Type::block,
+				Integrator::Type::wisdom_holman })
+			{
+				if (ImGui::MenuItem(Integrator::get_name(type), nullptr, snapshot->integrator == type))
+				{
+					simulation.push([type](World& world) { world.set_integrator(type); });
+				}
+			}
+
+			ImGui::Separator();
+
+			float time_step = simulation.get_time_step();
+			if (ImGui::SliderFloat("Time step", &time_step, 0.001f, 0.1f, "%.4f"))
+			{
+				simulation.set_time_step(time_step);
+			}
+
+			float tolerance = snapshot->tolerance;
+			if (ImGui::SliderFloat("Tolerance", &tolerance, 0.0f, 0.1f, "%.3f"))
+			{
+				simulation.push([tolerance](World& world) { world.set_tolerance(tolerance); });
+			}
+
+			ImGui::Separator();
+
+			ImGui::Text("Direct kernel: %s", Gravity::get_isa_name(Gravity::get_isa()));
+			ImGui::Text("Threads: %u", snapshot->threads);
+			ImGui::Text("Simulated time: %.1f s", snapshot->time);
+			ImGui::Text("Last step: %.5f s", snapshot->step);
+
+			ImGui::EndMenu();
 		}
 
 		if (ImGui::Button("Quit"))
@@ -167,19 +307,37 @@ void Game::draw_ui()
 		}
 	} ImGui::EndMainMenuBar();
 
+	// the selected body may have been destroyed
+	std::optional<std::size_t> selected_index;
+	if (selected_obj)
+	{
+		selected_index = snapshot->find(*selected_obj);
+
+		if (!selected_index)
+		{
+			selected_obj.reset();
+		}
+	}
+
+	if (replay.is_open())
+	{
+		draw_replay_ui();
+		return;
+	}
+
 	// Window with planet list
 	if (ImGui::Begin("Planets"))
 	{
 		if (ImGui::Button("None"))
 		{
-			selected_obj = nullptr;
+			selected_obj.reset();
 		}
 
-		for (const auto& obj: world.get_objs())
+		for (std::size_t i = 0; i < snapshot->name.size(); i++)
 		{
-			if (ImGui::Button(obj->get_name().c_str()))
+			if (ImGui::Button(snapshot->name[i].c_str()))
 			{
-				selected_obj = obj;
+				selected_obj = snapshot->handles[i];
 			}
 		}
 
@@ -187,47 +345,100 @@ void Game::draw_ui()
 
 	// Window if planet is selected
 	if (
-		selected_obj != nullptr &&
-		ImGui::Begin(selected_obj->get_name().c_str())
+		selected_index &&
+		ImGui::Begin(snapshot->name[*selected_index].c_str())
 	)
 	{
-		switch (selected_obj->type)
+		const std::size_t index = *selected_index;
+		const Handle handle = *selected_obj;
+		float radius = snapshot->radius[index];
+		float density = snapshot->density[index];
+		sf::Vector2f vel(snapshot->vel_x[index], snapshot->vel_y[index]);
+
+		// the edits run on the simulation thread
+		auto edit = [&](const std::function<void(CelestialBody*)> func)
 		{
-			case GameObject::Type::celestial_body:
+			simulation.push([handle, func](World& world)
 			{
-				CelestialBody* cb = static_cast<CelestialBody*>(selected_obj);
-				float radius = cb->get_radius();
-				float density = cb->get_density();
-				sf::Vector2f vel = cb->get_vel();
-
-				if (ImGui::SliderFloat("Radius", &radius, 1.0f, 500.0f))
+				GameObject* obj = world.get_obj(handle);
+				if (obj)
 				{
-					cb->set_radius(radius);
+					func(static_cast<CelestialBody*>(obj));
 				}
+			});
+		};
 
-				if (ImGui::SliderFloat("Density", &density, 1.0f, 1000.0f))
-				{
-					cb->set_density(density);
-				}
+		if (ImGui::SliderFloat("Radius", &radius, 1.0f, 500.0f))
+		{
+			edit([radius](CelestialBody* cb) { cb->set_radius(radius); });
+		}
 
-				if (ImGui::SliderFloat("X-Vel", &vel.x, -500.0f, 500.0f))
-				{
-					cb->set_vel(vel);
-				}
+		if (ImGui::SliderFloat("Density", &density, 1.0f, 1000.0f))
+		{
+			edit([density](CelestialBody* cb) { cb->set_density(density); });
+		}
 
-				if (ImGui::SliderFloat("Y-Vel", &vel.y, -500.0f, 500.0f))
-				{
-					cb->set_vel(vel);
-				}
+		if (ImGui::SliderFloat("X-Vel", &vel.x, -500.0f, 500.0f))
+		{
+			edit([vel](CelestialBody* cb) { cb->set_vel(vel); });
+		}
 
-			}	break;
+		if (ImGui::SliderFloat("Y-Vel", &vel.y, -500.0f, 500.0f))
+		{
+			edit([vel](CelestialBody* cb) { cb->set_vel(vel); });
+		}
 
-			default:
-				break;
+		if (ImGui::Button("Delete"))
+		{
+			simulation.push([handle](World& world) { world.destroy(handle); });
+			selected_obj.reset();
 		}
+
 	ImGui::End(); }
 }
 
+void Game::draw_replay_ui()
+{
+	if (ImGui::Begin("Replay"))
+	{
+		if (ImGui::Button(replay.is_playing() ? "II" : "|>"))
+		{
+			// play again from the start once the end is reached
+			if (!replay.is_playing() && replay.get_position() >= replay.get_frame_count() - 1)
+			{
+				replay.set_position(0.0);
+			}
+
+			replay.set_playing(!replay.is_playing());
+		}
+
+		ImGui::SameLine();
+
+		if (ImGui::Button("Close"))
+		{
+			replay.close();
+		}
+
+		if (replay.is_open())
+		{
+			float position = (float)replay.get_position();
+			if (ImGui::SliderFloat("Frame", &position, 0.0f, (float)(replay.get_frame_count() - 1), "%.0f"))
+			{
+				replay.set_position(position);
+			}
+
+			float speed = replay.get_speed();
+			if (ImGui::SliderFloat("Frames/s", &speed, 1.0f, 240.0f))
+			{
+				replay.set_speed(speed);
+			}
+
+			ImGui::Text("Frames: %zu", replay.get_frame_count());
+		}
+
+	} ImGui::End();
+}
+
 void Game::handle_events()
 {
 	sf::Event event;
@@ -27,33 +27,32 @@
 
 #include "game_object.hpp"
 
-unsigned int GameObject::id = 0;
-
-GameObject::GameObject(const Type type):
-	type(type)
-{
-	set_name(std::to_string(id));
-	id++;
-}
+GameObject::GameObject(const Type type, ParticleStore& particles):
+	type(type),
+	particles(particles),
+	index(particles.add())
+{}
 
 GameObject::~GameObject()
-{
-	id--;
-}
+{}
 
 sf::Vector2f GameObject::get_pos() const
 {
-	return pos;
+	return sf::Vector2f(particles.pos_x[index], particles.pos_y[index]);
 }
 
 sf::Vector2f GameObject::get_vel() const
 {
-	return vel;
+	return sf::Vector2f(particles.vel_x[index], particles.vel_y[index]);
 }
 
 void GameObject::set_pos(const sf::Vector2f pos)
 {
-	this->pos = pos;
+	particles.pos_x[index] = pos.x;
+	particles.pos_y[index] = pos.y;
+	particles.prev_pos_x[index] = pos.x;
+	particles.prev_pos_y[index] = pos.y;
+	particles.acc_valid = false;
 }
 
 void GameObject::set_pos(const float p_x, const float p_y)
@@ -63,7 +62,8 @@ void GameObject::set_pos(const float p_x, const float p_y)
 
 void GameObject::set_vel(const sf::Vector2f vel)
 {
-	this->vel = vel;
+	particles.vel_x[index] = vel.x;
+	particles.vel_y[index] = vel.y;
 }
 
 void GameObject::set_vel(const float v_x, const float v_y)
@@ -73,7 +73,17 @@ void GameObject::set_vel(const float v_x, const float v_y)
 
 float GameObject::get_mass() const
 {
-	return mass;
+	return particles.mass[index];
+}
+
+std::size_t GameObject::get_index() const
+{
+	return index;
+}
+
+void GameObject::set_index(const std::size_t index)
+{
+	this->index = index;
 }
 
 float GameObject::calc_magnitude(const sf::Vector2f vec)
@@ -83,7 +93,8 @@ float GameObject::calc_magnitude(const sf::Vector2f vec)
 
 void GameObject::accelerate(const sf::Vector2<float> a)
 {
-	vel += a;
+	particles.vel_x[index] += a.x;
+	particles.vel_y[index] += a.y;
 }
 
 void GameObject::accelerate(const float a_x, const float a_y)
@@ -93,7 +104,7 @@ void GameObject::accelerate(const float a_x, const float a_y)
 
 float GameObject::calc_acceleration(const float F)
 {
-	return F / mass;
+	return F / get_mass();
 }
 
 float GameObject::calc_orbital_velocity(const float G, const GameObject* const obj)
@@ -115,24 +126,24 @@ float GameObject::calc_orbital_velocity(const float G, const std::vector<GameObj
 
 float GameObject::calc_distance(const GameObject* const obj) const
 {
-	const sf::Vector2f dist = pos - obj->get_pos();
+	const sf::Vector2f dist = get_pos() - obj->get_pos();
 	return std::sqrt(dist.x * dist.x + dist.y * dist.y);
 }
 
 float GameObject::calc_distance_sq(const GameObject* const obj) const
 {
-	const sf::Vector2f dist = pos - obj->get_pos();
+	const sf::Vector2f dist = get_pos() - obj->get_pos();
 	return dist.x * dist.x + dist.y * dist.y;
 }
 
 float GameObject::calc_gravitation(const float G, const GameObject* const obj) const
 {
-	return (G * mass * obj->get_mass()) / calc_distance_sq(obj);
+	return (G * get_mass() * obj->get_mass()) / calc_distance_sq(obj);
 }
 
 float GameObject::calc_angle(const GameObject* const obj) const
 {
-	const sf::Vector2f dist = pos - obj->get_pos();
+	const sf::Vector2f dist = get_pos() - obj->get_pos();
 
 	float angle = std::atan2(dist.y, dist.x) * 180.0f / float(M_PI);
 
@@ -156,9 +167,8 @@ bool GameObject::compare(const GameObject* const obj) const
 {
 	return
 	(
-		pos		== obj->pos		&&
-		vel		== obj->vel		&&
-		mass	== obj->mass
+		&particles	== &obj->particles	&&
+		index		== obj->index
 	);
 }
 
@@ -0,0 +1,475 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "gravity.hpp"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+	#define SOLYS_X86
+	#include <immintrin.h>
+#endif
+
+Gravity::Isa Gravity::isa = Gravity::detect_isa();
+
+/* KERNELS */
+
+/**
+ * @brief Plain direct sum at the targets [begin, end), also handles the remainder of the vector kernels
+ */
+static void direct_scalar(const float G, const float eps_sq,
+	const float* pos_x, const float* pos_y, const float* mass, const std::size_t count,
+	const float* target_x, const float* target_y,
+	const std::size_t begin, const std::size_t end, float* acc_x, float* acc_y)
+{
+	for (std::size_t i = begin; i < end; i++)
+	{
+		const float x = target_x[i];
+		const float y = target_y[i];
+		float a_x = 0.0f, a_y = 0.0f;
+
+		for (std::size_t j = 0; j < count; j++)
+		{
+			Gravity::accumulate(pos_x[j] - x, pos_y[j] - y, mass[j], eps_sq, a_x, a_y);
+		}
+
+		acc_x[i] = G * a_x;
+		acc_y[i] = G * a_y;
+	}
+}
+
+/**
+ * @brief Pairs of body i with the bodies [begin, end), both sides get their acceleration without G
+ */
+static void pairs_scalar(const float eps_sq, const float* pos_x, const float* pos_y, const float* mass,
+	const std::size_t i, const std::size_t begin, const std::size_t end, float* acc_x, float* acc_y)
+{
+	const float x = pos_x[i];
+	const float y = pos_y[i];
+	const float m = mass[i];
+	float a_x = 0.0f, a_y = 0.0f;
+
+	for (std::size_t j = begin; j < end; j++)
+	{
+		const float d_x = pos_x[j] - x;
+		const float d_y = pos_y[j] - y;
+		const float r_sq = d_x * d_x + d_y * d_y + eps_sq;
+		const float inv_r = r_sq > 0.0f ? 1.0f / std::sqrt(r_sq) : 0.0f;
+		const float inv_r3 = inv_r * inv_r * inv_r;
+
+		// equal and opposite, the masses are swapped
+		a_x += d_x * mass[j] * inv_r3;
+		a_y += d_y * mass[j] * inv_r3;
+		acc_x[j] -= d_x * m * inv_r3;
+		acc_y[j] -= d_y * m * inv_r3;
+	}
+
+	acc_x[i] += a_x;
+	acc_y[i] += a_y;
+}
+
+#ifdef SOLYS_X86
+
+/**
+ * @brief Direct sum for 8 bodies at once
+ */
+__attribute__((target("avx2,fma")))
+static void direct_avx2(const float G, const float eps_sq,
+	const float* pos_x, const float* pos_y, const float* mass, const std::size_t count,
+	const float* target_x, const float* target_y,
+	const std::size_t begin, const std::size_t end, float* acc_x, float* acc_y)
+{
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 half = _mm256_set1_ps(0.5f);
+	const __m256 three_halves = _mm256_set1_ps(1.5f);
+	const __m256 eps = _mm256_set1_ps(eps_sq);
+	const __m256 g = _mm256_set1_ps(G);
+
+	std::size_t i = begin;
+
+	for (; i + 8 <= end; i += 8)
+	{
+		const __m256 x = _mm256_loadu_ps(target_x + i);
+		const __m256 y = _mm256_loadu_ps(target_y + i);
+		__m256 a_x = zero, a_y = zero;
+
+		for (std::size_t j = 0; j < count; j++)
+		{
+			const __m256 d_x = _mm256_sub_ps(_mm256_set1_ps(pos_x[j]), x);
+			const __m256 d_y = _mm256_sub_ps(_mm256_set1_ps(pos_y[j]), y);
+			const __m256 r_sq = _mm256_fmadd_ps(d_x, d_x, _mm256_fmadd_ps(d_y, d_y, eps));
+
+			// rsqrt estimate refined with one newton step, bodies at distance 0 are masked out
+			__m256 inv_r = _mm256_rsqrt_ps(r_sq);
+			inv_r = _mm256_mul_ps(inv_r,
+				_mm256_fnmadd_ps(_mm256_mul_ps(half, r_sq), _mm256_mul_ps(inv_r, inv_r), three_halves));
+			inv_r = _mm256_and_ps(inv_r, _mm256_cmp_ps(r_sq, zero, _CMP_GT_OQ));
+
+			const __m256 f = _mm256_mul_ps(_mm256_set1_ps(mass[j]),
+				_mm256_mul_ps(inv_r, _mm256_mul_ps(inv_r, inv_r)));
+			a_x = _mm256_fmadd_ps(d_x, f, a_x);
+			a_y = _mm256_fmadd_ps(d_y, f, a_y);
+		}
+
+		_mm256_storeu_ps(acc_x + i, _mm256_mul_ps(g, a_x));
+		_mm256_storeu_ps(acc_y + i, _mm256_mul_ps(g, a_y));
+	}
+
+	direct_scalar(G, eps_sq, pos_x, pos_y, mass, count, target_x, target_y, i, end, acc_x, acc_y);
+}
+
+/**
+ * @brief Direct sum for 16 bodies at once
+ */
+__attribute__((target("avx512f")))
+static void direct_avx512(const float G, const float eps_sq,
+	const float* pos_x, const float* pos_y, const float* mass, const std::size_t count,
+	const float* target_x, const float* target_y,
+	const std::size_t begin, const std::size_t end, float* acc_x, float* acc_y)
+{
+	const __m512 zero = _mm512_setzero_ps();
+	const __m512 half = _mm512_set1_ps(0.5f);
+	const __m512 three_halves = _mm512_set1_ps(1.5f);
+	const __m512 eps = _mm512_set1_ps(eps_sq);
+	const __m512 g = _mm512_set1_ps(G);
+
+	std::size_t i = begin;
+
+	for (; i + 16 <= end; i += 16)
+	{
+		const __m512 x = _mm512_loadu_ps(target_x + i);
+		const __m512 y = _mm512_loadu_ps(target_y + i);
+		__m512 a_x = zero, a_y = zero;
+
+		for (std::size_t j = 0; j < count; j++)
+		{
+			const __m512 d_x = _mm512_sub_ps(_mm512_set1_ps(pos_x[j]), x);
+			const __m512 d_y = _mm512_sub_ps(_mm512_set1_ps(pos_y[j]), y);
+			const __m512 r_sq = _mm512_fmadd_ps(d_x, d_x, _mm512_fmadd_ps(d_y, d_y, eps));
+
+			// rsqrt estimate refined with one newton step, bodies at distance 0 are masked out
+			const __mmask16 nonzero = _mm512_cmp_ps_mask(r_sq, zero, _CMP_GT_OQ);
+			__m512 inv_r = _mm512_maskz_rsqrt14_ps(nonzero, r_sq);
+			inv_r = _mm512_mul_ps(inv_r,
+				_mm512_fnmadd_ps(_mm512_mul_ps(half, r_sq), _mm512_mul_ps(inv_r, inv_r), three_halves));
+
+			const __m512 f = _mm512_mul_ps(_mm512_set1_ps(mass[j]),
+				_mm512_mul_ps(inv_r, _mm512_mul_ps(inv_r, inv_r)));
+			a_x = _mm512_fmadd_ps(d_x, f, a_x);
+			a_y = _mm512_fmadd_ps(d_y, f, a_y);
+		}
+
+		_mm512_storeu_ps(acc_x + i, _mm512_mul_ps(g, a_x));
+		_mm512_storeu_ps(acc_y + i, _mm512_mul_ps(g, a_y));
+	}
+
+	direct_scalar(G, eps_sq, pos_x, pos_y, mass, count, target_x, target_y, i, end, acc_x, acc_y);
+}
+
+/**
+ * @brief Pairs of body i with 8 of the bodies [begin, end) at once
+ */
+__attribute__((target("avx2,fma")))
+static void pairs_avx2(const float eps_sq, const float* pos_x, const float* pos_y, const float* mass,
+	const std::size_t i, const std::size_t begin, const std::size_t end, float* acc_x, float* acc_y)
+{
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 half = _mm256_set1_ps(0.5f);
+	const __m256 three_halves = _mm256_set1_ps(1.5f);
+	const __m256 eps = _mm256_set1_ps(eps_sq);
+	const __m256 x = _mm256_set1_ps(pos_x[i]);
+	const __m256 y = _mm256_set1_ps(pos_y[i]);
+	const __m256 m = _mm256_set1_ps(mass[i]);
+	__m256 a_x = zero, a_y = zero;
+
+	std::size_t j = begin;
+
+	for (; j + 8 <= end; j += 8)
+	{
+		const __m256 d_x = _mm256_sub_ps(_mm256_loadu_ps(pos_x + j), x);
+		const __m256 d_y = _mm256_sub_ps(_mm256_loadu_ps(pos_y + j), y);
+		const __m256 r_sq = _mm256_fmadd_ps(d_x, d_x, _mm256_fmadd_ps(d_y, d_y, eps));
+
+		// rsqrt estimate refined with one newton step, bodies at distance 0 are masked out
+		__m256 inv_r = _mm256_rsqrt_ps(r_sq);
+		inv_r = _mm256_mul_ps(inv_r,
+			_mm256_fnmadd_ps(_mm256_mul_ps(half, r_sq), _mm256_mul_ps(inv_r, inv_r), three_halves));
+		inv_r = _mm256_and_ps(inv_r, _mm256_cmp_ps(r_sq, zero, _CMP_GT_OQ));
+		const __m256 inv_r3 = _mm256_mul_ps(inv_r, _mm256_mul_ps(inv_r, inv_r));
+
+		// equal and opposite, the masses are swapped
+		const __m256 f = _mm256_mul_ps(_mm256_loadu_ps(mass + j), inv_r3);
+		a_x = _mm256_fmadd_ps(d_x, f, a_x);
+		a_y = _mm256_fmadd_ps(d_y, f, a_y);
+
+		const __m256 f_j = _mm256_mul_ps(m, inv_r3);
+		_mm256_storeu_ps(acc_x + j, _mm256_fnmadd_ps(d_x, f_j, _mm256_loadu_ps(acc_x + j)));
+		_mm256_storeu_ps(acc_y + j, _mm256_fnmadd_ps(d_y, f_j, _mm256_loadu_ps(acc_y + j)));
+	}
+
+	// add up the lanes
+	float lanes_x[8], lanes_y[8];
+	_mm256_storeu_ps(lanes_x, a_x);
+	_mm256_storeu_ps(lanes_y, a_y);
+
+	for (unsigned int k = 0; k < 8; k++)
+	{
+		acc_x[i] += lanes_x[k];
+		acc_y[i] += lanes_y[k];
+	}
+
+	pairs_scalar(eps_sq, pos_x, pos_y, mass, i, j, end, acc_x, acc_y);
+}
+
+/**
+ * @brief Pairs of body i with 16 of the bodies [begin, end) at once
+ */
+__attribute__((target("avx512f")))
+static void pairs_avx512(const float eps_sq, const float* pos_x, const float* pos_y, const float* mass,
+	const std::size_t i, const std::size_t begin, const std::size_t end, float* acc_x, float* acc_y)
+{
+	const __m512 zero = _mm512_setzero_ps();
+	const __m512 half = _mm512_set1_ps(0.5f);
+	const __m512 three_halves = _mm512_set1_ps(1.5f);
+	const __m512 eps = _mm512_set1_ps(eps_sq);
+	const __m512 x = _mm512_set1_ps(pos_x[i]);
+	const __m512 y = _mm512_set1_ps(pos_y[i]);
+	const __m512 m = _mm512_set1_ps(mass[i]);
+	__m512 a_x = zero, a_y = zero;
+
+	std::size_t j = begin;
+
+	for (; j + 16 <= end; j += 16)
+	{
+		const __m512 d_x = _mm512_sub_ps(_mm512_loadu_ps(pos_x + j), x);
+		const __m512 d_y = _mm512_sub_ps(_mm512_loadu_ps(pos_y + j), y);
+		const __m512 r_sq = _mm512_fmadd_ps(d_x, d_x, _mm512_fmadd_ps(d_y, d_y, eps));
+
+		// rsqrt estimate refined with one newton step, bodies at distance 0 are masked out
+		const __mmask16 nonzero = _mm512_cmp_ps_mask(r_sq, zero, _CMP_GT_OQ);
+		__m512 inv_r = _mm512_maskz_rsqrt14_ps(nonzero, r_sq);
+		inv_r = _mm512_mul_ps(inv_r,
+			_mm512_fnmadd_ps(_mm512_mul_ps(half, r_sq), _mm512_mul_ps(inv_r, inv_r), three_halves));
+		const __m512 inv_r3 = _mm512_mul_ps(inv_r, _mm512_mul_ps(inv_r, inv_r));
+
+		// equal and opposite, the masses are swapped
+		const __m512 f = _mm512_mul_ps(_mm512_loadu_ps(mass + j), inv_r3);
+		a_x = _mm512_fmadd_ps(d_x, f, a_x);
+		a_y = _mm512_fmadd_ps(d_y, f, a_y);
+
+		const __m512 f_j = _mm512_mul_ps(m, inv_r3);
+		_mm512_storeu_ps(acc_x + j, _mm512_fnmadd_ps(d_x, f_j, _mm512_loadu_ps(acc_x + j)));
+		_mm512_storeu_ps(acc_y + j, _mm512_fnmadd_ps(d_y, f_j, _mm512_loadu_ps(acc_y + j)));
+	}
+
+	acc_x[i] += _mm512_reduce_add_ps(a_x);
+	acc_y[i] += _mm512_reduce_add_ps(a_y);
+
+	pairs_scalar(eps_sq, pos_x, pos_y, mass, i, j, end, acc_x, acc_y);
+}
+
+#endif
+
+/**
+ * @brief Direct sum at the targets [begin, end) with the best kernel of the instruction set
+ */
+static void direct_targets(const Gravity::Isa isa, const float G, const float eps_sq,
+	const float* pos_x, const float* pos_y, const float* mass, const std::size_t count,
+	const float* target_x, const float* target_y,
+	const std::size_t begin, const std::size_t end, float* acc_x, float* acc_y)
+{
+	switch (isa)
+	{
+#ifdef SOLYS_X86
+		case Gravity::Isa::avx512:
+			direct_avx512(G, eps_sq, pos_x, pos_y, mass, count, target_x, target_y, begin, end, acc_x, acc_y);
+			break;
+
+		case Gravity::Isa::avx2:
+			direct_avx2(G, eps_sq, pos_x, pos_y, mass, count, target_x, target_y, begin, end, acc_x, acc_y);
+			break;
+#endif
+
+		default:
+			direct_scalar(G, eps_sq, pos_x, pos_y, mass, count, target_x, target_y, begin, end, acc_x, acc_y);
+			break;
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+void Gravity::direct(const float G, const float eps_sq,
+	const float* pos_x, const float* pos_y, const float* mass, const std::size_t count,
+	const std::size_t begin, const std::size_t end, float* acc_x, float* acc_y)
+{
+	direct_targets(isa, G, eps_sq, pos_x, pos_y, mass, count, pos_x, pos_y, begin, end, acc_x, acc_y);
+}
+
+void Gravity::direct_at(const float G, const float eps_sq,
+	const float* pos_x, const float* pos_y, const float* mass, const std::size_t count,
+	const float* target_x, const float* target_y, const std::size_t target_count,
+	float* acc_x, float* acc_y)
+{
+	direct_targets(isa, G, eps_sq, pos_x, pos_y, mass, count, target_x, target_y, 0, target_count, acc_x, acc_y);
+}
+
+void Gravity::direct_symmetric(const float G, const float eps_sq,
+	const float* pos_x, const float* pos_y, const float* mass, const std::size_t count,
+	float* acc_x, float* acc_y, ThreadPool& pool)
+{
+	std::fill(acc_x, acc_x + count, 0.0f);
+	std::fill(acc_y, acc_y + count, 0.0f);
+
+	const std::size_t tiles = (count + tile_size - 1) / tile_size;
+
+	// pairs within a tile, every tile in parallel
+	pool.parallel_for(tiles, 1, [&](const std::size_t begin, const std::size_t end)
+	{
+		for (std::size_t t = begin; t < end; t++)
+		{
+			accumulate_pairs(eps_sq, pos_x, pos_y, mass,
+				t * tile_size, std::min(count, (t + 1) * tile_size), acc_x, acc_y);
+		}
+	});
+
+	// pairs of different tiles, scheduled like a round robin tournament;
+	// with an even number of slots (the last one may be empty) every round pairs each tile exactly once
+	const std::size_t slots = tiles + tiles % 2;
+
+	for (std::size_t round = 0; round + 1 < slots; round++)
+	{
+		pool.parallel_for(slots / 2, 1, [&](const std::size_t begin, const std::size_t end)
+		{
+			for (std::size_t k = begin; k < end; k++)
+			{
+				// slot 0 stays fixed, the others rotate
+				const std::size_t a = (k == 0) ? 0 : (round + k - 1) % (slots - 1) + 1;
+				const std::size_t b = (round + slots - 2 - k) % (slots - 1) + 1;
+
+				if (a >= tiles || b >= tiles)
+				{
+					continue;
+				}
+
+				accumulate_pairs(eps_sq, pos_x, pos_y, mass,
+					a * tile_size, std::min(count, (a + 1) * tile_size),
+					b * tile_size, std::min(count, (b + 1) * tile_size),
+					acc_x, acc_y);
+			}
+		});
+	}
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		acc_x[i] *= G;
+		acc_y[i] *= G;
+	}
+}
+
+void Gravity::accumulate_pairs(const float eps_sq,
+	const float* pos_x, const float* pos_y, const float* mass,
+	const std::size_t a_begin, const std::size_t a_end,
+	const std::size_t b_begin, const std::size_t b_end,
+	float* acc_x, float* acc_y)
+{
+	for (std::size_t i = a_begin; i < a_end; i++)
+	{
+		switch (isa)
+		{
+#ifdef SOLYS_X86
+			case Isa::avx512:
+				pairs_avx512(eps_sq, pos_x, pos_y, mass, i, b_begin, b_end, acc_x, acc_y);
+				break;
+
+			case Isa::avx2:
+				pairs_avx2(eps_sq, pos_x, pos_y, mass, i, b_begin, b_end, acc_x, acc_y);
+				break;
+#endif
+
+			default:
+				pairs_scalar(eps_sq, pos_x, pos_y, mass, i, b_begin, b_end, acc_x, acc_y);
+				break;
+		}
+	}
+}
+
+void Gravity::accumulate_pairs(const float eps_sq,
+	const float* pos_x, const float* pos_y, const float* mass,
+	const std::size_t begin, const std::size_t end,
+	float* acc_x, float* acc_y)
+{
+	for (std::size_t i = begin; i < end; i++)
+	{
+		accumulate_pairs(eps_sq, pos_x, pos_y, mass, i, i + 1, i + 1, end, acc_x, acc_y);
+	}
+}
+
+Gravity::Isa Gravity::detect_isa()
+{
+#ifdef SOLYS_X86
+	// may run during static initialization
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx512f"))
+	{
+		return Isa::avx512;
+	}
+
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+	{
+		return Isa::avx2;
+	}
+#endif
+
+	return Isa::scalar;
+}
+
+void Gravity::set_isa(const Isa isa)
+{
+	// never pick something the cpu can't run
+	Gravity::isa = (int)isa <= (int)detect_isa() ? isa : detect_isa();
+}
+
+Gravity::Isa Gravity::get_isa()
+{
+	return isa;
+}
+
+const char* Gravity::get_isa_name(const Isa isa)
+{
+	switch (isa)
+	{
+		case Isa::avx512:
+			return "avx512";
+
+		case Isa::avx2:
+			return "avx2";
+
+		default:
+			return "scalar";
+	}
+}
\ No newline at end of file
@@ -0,0 +1,207 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "headless.hpp"
+#include "scenario.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+bool Headless::init(const Config& config, const std::vector<std::string> args)
+{
+	world.load_settings(config);
+
+	time_step = config.get_value<float>("physics", "time-step");
+	if (time_step <= 0.0f)
+	{
+		time_step = 1.0f / 120.0f;
+	}
+
+	steps = 0;
+	end_time = 0.0;
+	record_every = 10;
+
+	// the first argument is the scenario, then options with one value each
+	if (args.empty() || args[0].rfind("--", 0) == 0)
+	{
+		print_usage();
+		return false;
+	}
+
+	for (std::size_t i = 1; i + 1 < args.size(); i += 2)
+	{
+		try
+		{
+			if (args[i] == "--steps")
+			{
+				steps = std::stoul(args[i + 1]);
+			}
+			else if (args[i] == "--time")
+			{
+				end_time = std::stod(args[i + 1]);
+			}
+			else if (args[i] == "--time-step")
+			{
+				time_step = std::stof(args[i + 1]);
+			}
+			else if (args[i] == "--tolerance")
+			{
+				world.set_tolerance(std::stof(args[i + 1]));
+			}
+			else if (args[i] == "--output")
+			{
+				output = args[i + 1];
+			}
+			else if (args[i] == "--record")
+			{
+				record = args[i + 1];
+			}
+			else if (args[i] == "--record-every")
+			{
+				record_every = std::stoul(args[i + 1]);
+			}
+			else
+			{
+				print_usage();
+				return false;
+			}
+		}
+		catch (...)
+		{
+			print_usage();
+			return false;
+		}
+	}
+
+	if (args.size() % 2 == 0 || (steps == 0 && end_time <= 0.0) || time_step <= 0.0f)
+	{
+		print_usage();
+		return false;
+	}
+
+	if (!Scenario::load(world, args[0]))
+	{
+		std::cerr << "Could not load scenario " << args[0] << std::endl;
+		return false;
+	}
+
+	if (!record.empty() && !recorder.open(record, record_every))
+	{
+		std::cerr << "Could not create recording " << record << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+void Headless::run()
+{
+	typedef std::chrono::steady_clock Clock;
+
+	unsigned long step = 0;
+	double time = 0.0;
+
+	const Clock::time_point start = Clock::now();
+
+	// time_step is the longest step with an adaptive time step
+	const bool adaptive = world.get_tolerance() > 0.0f;
+
+	// whichever limit is reached first, half a step of slack so rounding doesn't add a step
+	while ((steps == 0 || step < steps) && (end_time <= 0.0 || time + 0.5 * world.get_time_step(time_step) < end_time))
+	{
+		float dt = world.get_time_step(time_step);
+
+		// adaptive steps don't add up to end_time, cut the last one short
+		if (adaptive && end_time > 0.0)
+		{
+			dt = std::min(dt, (float)(end_time - time));
+		}
+
+		world.update(dt);
+		step++;
+		time = adaptive ? time + dt : step * (double)time_step;
+
+		recorder.record(world.get_particles(), time);
+	}
+
+	recorder.close();
+
+	const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	if (!output.empty() && !write_results(output))
+	{
+		std::cerr << "Could not write " << output << std::endl;
+	}
+
+	std::cout
+		<< "bodies: " << world.get_particles().size() << "\n"
+		<< "steps: " << step << "\n"
+		<< "simulated time: " << time << " s\n"
+		<< "mean step: " << (step > 0 ? time / step : 0.0) << " s\n"
+		<< "wall time: " << seconds << " s\n"
+		<< "steps/s: " << (seconds > 0.0 ? step / seconds : 0.0) << std::endl;
+
+	if (!record.empty())
+	{
+		std::cout << "dropped frames: " << recorder.get_dropped() << std::endl;
+	}
+}
+
+void Headless::print_usage()
+{
+	std::cerr
+		<< "usage: solys --headless <scenario> [--steps N] [--time T] [--time-step DT] [--output FILE]\n"
+		<< "\t[--tolerance TOL] [--record FILE] [--record-every N]\n"
+		<< "\tat least one of --steps and --time is required" << std::endl;
+}
+
+bool Headless::write_results(const std::string filename) const
+{
+	std::ofstream file(filename);
+
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	const ParticleStore& particles = world.get_particles();
+
+	file << "index,pos_x,pos_y,vel_x,vel_y,mass,radius\n";
+
+	for (std::size_t i = 0; i < particles.size(); i++)
+	{
+		file
+			<< i << ","
+			<< particles.pos_x[i] << "," << particles.pos_y[i] << ","
+			<< particles.vel_x[i] << "," << particles.vel_y[i] << ","
+			<< particles.mass[i] << "," << particles.radius[i] << "\n";
+	}
+
+	return file.good();
+}
\ No newline at end of file
@@ -0,0 +1,566 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "integrator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+/* INTEGRATOR */
+
+Integrator* Integrator::create(const Type type, const float G)
+{
+	switch (type)
+	{
+		case Type::euler:
+			return new EulerIntegrator();
+
+		case Type::velocity_verlet:
+			return new VerletIntegrator();
+
+		case Type::yoshida:
+			return new YoshidaIntegrator();
+
+		case Type::block:
+			return new BlockIntegrator();
+
+		case Type::wisdom_holman:
+			return new WisdomHolmanIntegrator(G);
+
+		default:
+			return new LeapfrogIntegrator();
+	}
+}
+
+const char* Integrator::get_name(const Type type)
+{
+	switch (type)
+	{
+		case Type::euler:
+			return "euler";
+
+		case Type::velocity_verlet:
+			return "verlet";
+
+		case Type::yoshida:
+			return "yoshida";
+
+		case Type::block:
+			return "block";
+
+		case Type::wisdom_holman:
+			return "wisdom-holman";
+
+		default:
+			return "leapfrog";
+	}
+}
+
+void Integrator::kick(ParticleStore& particles, const float time)
+{
+	const std::size_t count = particles.size();
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		particles.vel_x[i] += particles.acc_x[i] * time;
+		particles.vel_y[i] += particles.acc_y[i] * time;
+	}
+}
+
+void Integrator::drift(ParticleStore& particles, const float time)
+{
+	const std::size_t count = particles.size();
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		particles.pos_x[i] += particles.vel_x[i] * time;
+		particles.pos_y[i] += particles.vel_y[i] * time;
+	}
+}
+
+void Integrator::ensure_accelerations(ParticleStore& particles, const Forces& forces)
+{
+	if (!particles.acc_valid)
+	{
+		forces();
+	}
+}
+
+/* EULER */
+
+void EulerIntegrator::step(ParticleStore& particles, const Forces& forces, const ActiveForces&,
+	const float time)
+{
+	ensure_accelerations(particles, forces);
+	kick(particles, time);
+	drift(particles, time);
+
+	// the positions changed after the force calculation
+	particles.acc_valid = false;
+}
+
+/* LEAPFROG */
+
+void LeapfrogIntegrator::step(ParticleStore& particles, const Forces& forces, const ActiveForces&,
+	const float time)
+{
+	ensure_accelerations(particles, forces);
+	kick(particles, time * 0.5f);
+	drift(particles, time);
+
+	forces();
+	kick(particles, time * 0.5f);
+
+	particles.acc_valid = true;
+}
+
+/* VELOCITY VERLET */
+
+void VerletIntegrator::step(ParticleStore& particles, const Forces& forces, const ActiveForces&,
+	const float time)
+{
+	const std::size_t count = particles.size();
+
+	ensure_accelerations(particles, forces);
+
+	// p += v * t + a * t^2 / 2
+	for (std::size_t i = 0; i < count; i++)
+	{
+		particles.pos_x[i] += (particles.vel_x[i] + particles.acc_x[i] * time * 0.5f) * time;
+		particles.pos_y[i] += (particles.vel_y[i] + particles.acc_y[i] * time * 0.5f) * time;
+	}
+
+	old_acc_x = particles.acc_x;
+	old_acc_y = particles.acc_y;
+	forces();
+
+	// v += (a_old + a_new) * t / 2
+	for (std::size_t i = 0; i < count; i++)
+	{
+		particles.vel_x[i] += (old_acc_x[i] + particles.acc_x[i]) * time * 0.5f;
+		particles.vel_y[i] += (old_acc_y[i] + particles.acc_y[i]) * time * 0.5f;
+	}
+
+	particles.acc_valid = true;
+}
+
+/* YOSHIDA */
+
+void YoshidaIntegrator::step(ParticleStore& particles, const Forces& forces, const ActiveForces&,
+	const float time)
+{
+	// w1 = 1 / (2 - 2^(1/3)), w0 = -2^(1/3) / (2 - 2^(1/3))
+	static const float cbrt2 = std::cbrt(2.0f);
+	static const float w1 = 1.0f / (2.0f - cbrt2);
+	static const float w0 = -cbrt2 / (2.0f - cbrt2);
+
+	static const float c[4] = { w1 * 0.5f, (w0 + w1) * 0.5f, (w0 + w1) * 0.5f, w1 * 0.5f };
+	static const float d[3] = { w1, w0, w1 };
+
+	for (int k = 0; k < 3; k++)
+	{
+		drift(particles, c[k] * time);
+		forces();
+		kick(particles, d[k] * time);
+	}
+
+	drift(particles, c[3] * time);
+
+	particles.acc_valid = false;
+}
+
+/* BLOCK */
+
+void BlockIntegrator::step(ParticleStore& particles, const Forces& forces, const ActiveForces& active_forces,
+	const float time)
+{
+	const std::size_t count = particles.size();
+
+	// the World step in ticks of the finest level, a body on level l steps every 2^(max_level - l) ticks
+	constexpr std::uint32_t ticks = 1u << max_level;
+	const float tick = time / ticks;
+
+	ensure_accelerations(particles, forces);
+
+	old_acc_x.resize(count);
+	old_acc_y.resize(count);
+
+	// bodies the integrator doesn't know yet start on the finest level, all bodies start a step
+	for (std::size_t i = 0; i < count; i++)
+	{
+		std::uint8_t& level = particles.step_level[i];
+		level = std::min(level, max_level);
+
+		const float half = tick * (float)(ticks >> level) * 0.5f;
+		particles.vel_x[i] += particles.acc_x[i] * half;
+		particles.vel_y[i] += particles.acc_y[i] * half;
+	}
+
+	std::uint32_t t = 0;
+	while (t < ticks)
+	{
+		// the next tick a body ends its step, the finest level in use decides
+		std::uint8_t finest = 0;
+		for (std::size_t i = 0; i < count; i++)
+		{
+			finest = std::max(finest, particles.step_level[i]);
+		}
+
+		const std::uint32_t stride = ticks >> finest;
+		const std::uint32_t next = (t / stride + 1) * stride;
+
+		drift(particles, tick * (float)(next - t));
+		t = next;
+
+		active.clear();
+		for (std::uint32_t i = 0; i < count; i++)
+		{
+			if (t % (ticks >> particles.step_level[i]) == 0)
+			{
+				active.push_back(i);
+				old_acc_x[i] = particles.acc_x[i];
+				old_acc_y[i] = particles.acc_y[i];
+			}
+		}
+
+		active_forces(active);
+
+		for (const std::uint32_t i: active)
+		{
+			std::uint8_t& level = particles.step_level[i];
+			const float step = tick * (float)(ticks >> level);
+
+			// end the step
+			particles.vel_x[i] += particles.acc_x[i] * step * 0.5f;
+			particles.vel_y[i] += particles.acc_y[i] * step * 0.5f;
+
+			const float jerk_x = (particles.acc_x[i] - old_acc_x[i]) / step;
+			const float jerk_y = (particles.acc_y[i] - old_acc_y[i]) / step;
+
+			level = choose_level(std::hypot(particles.acc_x[i], particles.acc_y[i]),
+				std::hypot(jerk_x, jerk_y), level, time, t);
+
+			// start the next one, the last is started by the next call
+			if (t < ticks)
+			{
+				const float half = tick * (float)(ticks >> level) * 0.5f;
+				particles.vel_x[i] += particles.acc_x[i] * half;
+				particles.vel_y[i] += particles.acc_y[i] * half;
+			}
+		}
+	}
+
+	// every body ended its step with new accelerations
+	particles.acc_valid = true;
+}
+
+std::uint8_t BlockIntegrator::choose_level(const float acc, const float jerk, const std::uint8_t level,
+	const float time, const std::uint32_t tick)
+{
+	// a body without jerk moves in a straight line, the longest step is fine
+	std::uint8_t wanted = 0;
+	if (jerk > 0.0f)
+	{
+		const float step = eta * acc / jerk;
+		if (step < time)
+		{
+			wanted = (std::uint8_t)std::min((float)max_level, std::ceil(std::log2(time / step)));
+		}
+	}
+
+	if (wanted >= level)
+	{
+		return wanted;
+	}
+
+	// coarser levels must stay in sync with the bodies already on them
+	std::uint8_t coarser = level;
+	while (coarser > wanted && tick % ((1u << max_level) >> (coarser - 1)) == 0)
+	{
+		coarser--;
+	}
+
+	return coarser;
+}
+
+/* WISDOM-HOLMAN */
+
+WisdomHolmanIntegrator::WisdomHolmanIntegrator(const float G):
+	G(G)
+{}
+
+void WisdomHolmanIntegrator::step(ParticleStore& particles, const Forces& forces, const ActiveForces&,
+	const float time)
+{
+	const std::size_t count = particles.size();
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	// the central body may change when bodies are added or merge, so find it every step
+	central = 0;
+	total_mass = 0.0;
+	center_x = center_y = center_vel_x = center_vel_y = 0.0;
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		if (particles.mass[i] > particles.mass[central])
+		{
+			central = i;
+		}
+
+		total_mass += particles.mass[i];
+		center_x += (double)particles.mass[i] * particles.pos_x[i];
+		center_y += (double)particles.mass[i] * particles.pos_y[i];
+		center_vel_x += (double)particles.mass[i] * particles.vel_x[i];
+		center_vel_y += (double)particles.mass[i] * particles.vel_y[i];
+	}
+
+	central_mass = particles.mass[central];
+
+	// nothing to orbit, the bodies fly straight
+	if (central_mass <= 0.0)
+	{
+		drift(particles, time);
+		particles.acc_valid = false;
+		return;
+	}
+
+	center_x /= total_mass;
+	center_y /= total_mass;
+	center_vel_x /= total_mass;
+	center_vel_y /= total_mass;
+
+	rel_pos_x.resize(count);
+	rel_pos_y.resize(count);
+	bary_vel_x.resize(count);
+	bary_vel_y.resize(count);
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		rel_pos_x[i] = (double)particles.pos_x[i] - particles.pos_x[central];
+		rel_pos_y[i] = (double)particles.pos_y[i] - particles.pos_y[central];
+		bary_vel_x[i] = particles.vel_x[i] - center_vel_x;
+		bary_vel_y[i] = particles.vel_y[i] - center_vel_y;
+	}
+
+	kepler_drift(time * 0.5);
+	jump(particles, time * 0.5);
+
+	// without the central mass the force calculation only sees the other bodies
+	write_positions(particles);
+
+	const float mass = particles.mass[central];
+	particles.mass[central] = 0.0f;
+	forces();
+	particles.mass[central] = mass;
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		if (i != central)
+		{
+			bary_vel_x[i] += particles.acc_x[i] * (double)time;
+			bary_vel_y[i] += particles.acc_y[i] * (double)time;
+		}
+	}
+
+	jump(particles, time * 0.5);
+	kepler_drift(time * 0.5);
+
+	// back to cartesian coordinates, the center of mass moves in a straight line
+	center_x += center_vel_x * time;
+	center_y += center_vel_y * time;
+	write_positions(particles);
+
+	double momentum_x = 0.0, momentum_y = 0.0;
+	for (std::size_t i = 0; i < count; i++)
+	{
+		if (i != central)
+		{
+			momentum_x += particles.mass[i] * bary_vel_x[i];
+			momentum_y += particles.mass[i] * bary_vel_y[i];
+			particles.vel_x[i] = (float)(bary_vel_x[i] + center_vel_x);
+			particles.vel_y[i] = (float)(bary_vel_y[i] + center_vel_y);
+		}
+	}
+
+	particles.vel_x[central] = (float)(center_vel_x - momentum_x / central_mass);
+	particles.vel_y[central] = (float)(center_vel_y - momentum_y / central_mass);
+
+	// the accelerations are missing the central body
+	particles.acc_valid = false;
+}
+
+void WisdomHolmanIntegrator::kepler_drift(const double time)
+{
+	const double mu = G * central_mass;
+
+	for (std::size_t i = 0; i < rel_pos_x.size(); i++)
+	{
+		if (i != central)
+		{
+			solve_kepler(mu, time, rel_pos_x[i], rel_pos_y[i], bary_vel_x[i], bary_vel_y[i]);
+		}
+	}
+}
+
+void WisdomHolmanIntegrator::jump(const ParticleStore& particles, const double time)
+{
+	// the central body moves with the opposite momentum of all others
+	double momentum_x = 0.0, momentum_y = 0.0;
+	for (std::size_t i = 0; i < rel_pos_x.size(); i++)
+	{
+		if (i != central)
+		{
+			momentum_x += particles.mass[i] * bary_vel_x[i];
+			momentum_y += particles.mass[i] * bary_vel_y[i];
+		}
+	}
+
+	const double shift_x = momentum_x / central_mass * time;
+	const double shift_y = momentum_y / central_mass * time;
+
+	for (std::size_t i = 0; i < rel_pos_x.size(); i++)
+	{
+		if (i != central)
+		{
+			rel_pos_x[i] += shift_x;
+			rel_pos_y[i] += shift_y;
+		}
+	}
+}
+
+void WisdomHolmanIntegrator::solve_kepler(const double mu, const double time,
+	double& p_x, double& p_y, double& v_x, double& v_y)
+{
+	const double r0 = std::sqrt(p_x * p_x + p_y * p_y);
+
+	// on top of the central body there is no orbit to follow
+	if (r0 <= 0.0)
+	{
+		p_x += v_x * time;
+		p_y += v_y * time;
+		return;
+	}
+
+	const double sqrt_mu = std::sqrt(mu);
+	const double v0_sq = v_x * v_x + v_y * v_y;
+	const double radial = (p_x * v_x + p_y * v_y) / sqrt_mu;
+
+	// 1 / semi-major axis, negative for hyperbolic orbits
+	const double alpha = 2.0 / r0 - v0_sq / mu;
+
+	// stumpff functions c(z) and s(z), series near 0 where the closed forms cancel out
+	const auto stumpff = [](const double z, double& c, double& s)
+	{
+		if (std::abs(z) < 1e-4)
+		{
+			c = 0.5 - z / 24.0 + z * z / 720.0;
+			s = 1.0 / 6.0 - z / 120.0 + z * z / 5040.0;
+		}
+		else if (z > 0.0)
+		{
+			const double q = std::sqrt(z);
+			c = (1.0 - std::cos(q)) / z;
+			s = (q - std::sin(q)) / (z * q);
+		}
+		else
+		{
+			const double q = std::sqrt(-z);
+			c = (std::cosh(q) - 1.0) / -z;
+			s = (std::sinh(q) - q) / (-z * q);
+		}
+	};
+
+	// universal kepler equation in x, solved with laguerre's method, it converges from almost any start
+	double x = alpha > 0.0 ? sqrt_mu * alpha * time : sqrt_mu * time / r0;
+	double c = 0.5, s = 1.0 / 6.0;
+
+	for (int iteration = 0; iteration < 50; iteration++)
+	{
+		const double z = alpha * x * x;
+		stumpff(z, c, s);
+
+		const double f = radial * x * x * c + (1.0 - alpha * r0) * x * x * x * s + r0 * x - sqrt_mu * time;
+		const double df = radial * x * (1.0 - z * s) + (1.0 - alpha * r0) * x * x * c + r0;
+		const double ddf = radial * (1.0 - z * c) + (1.0 - alpha * r0) * x * (1.0 - z * s);
+
+		const double n = 5.0;
+		const double root = std::sqrt(std::abs((n - 1.0) * (n - 1.0) * df * df - n * (n - 1.0) * f * ddf));
+		const double delta = n * f / (df + (df >= 0.0 ? root : -root));
+
+		x -= delta;
+
+		if (std::abs(delta) <= 1e-14 * std::max(1.0, std::abs(x)))
+		{
+			break;
+		}
+	}
+
+	const double z = alpha * x * x;
+	stumpff(z, c, s);
+
+	// lagrange coefficients
+	const double f = 1.0 - x * x / r0 * c;
+	const double g = time - x * x * x / sqrt_mu * s;
+
+	const double new_x = f * p_x + g * v_x;
+	const double new_y = f * p_y + g * v_y;
+	const double r = std::sqrt(new_x * new_x + new_y * new_y);
+
+	const double df = sqrt_mu / (r * r0) * (alpha * x * x * x * s - x);
+	const double dg = 1.0 - x * x / r * c;
+
+	v_x = df * p_x + dg * v_x;
+	v_y = df * p_y + dg * v_y;
+	p_x = new_x;
+	p_y = new_y;
+}
+
+void WisdomHolmanIntegrator::write_positions(ParticleStore& particles) const
+{
+	const std::size_t count = particles.size();
+
+	// the central body sits where it keeps the center of mass in place
+	double sum_x = 0.0, sum_y = 0.0;
+	for (std::size_t i = 0; i < count; i++)
+	{
+		sum_x += particles.mass[i] * rel_pos_x[i];
+		sum_y += particles.mass[i] * rel_pos_y[i];
+	}
+
+	const double central_x = center_x - sum_x / total_mass;
+	const double central_y = center_y - sum_y / total_mass;
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		particles.pos_x[i] = (float)(central_x + rel_pos_x[i]);
+		particles.pos_y[i] = (float)(central_y + rel_pos_y[i]);
+	}
+}
\ No newline at end of file
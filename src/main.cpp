@@ -26,23 +26,43 @@
  */
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "sfml.hpp"
 #include "game.hpp"
+#include "headless.hpp"
 #include "config.hpp"
 
-int main()
+int main(int argc, char* argv[])
 {
 	srand(uint32_t(time(time_t(0))));
 
 	Config config;
-	Game game;
 
 	if (!config.load("data/settings"))
 	{
 		// TODO: create settings file with standard settings
 	}
 
+	const std::vector<std::string> args(argv + 1, argv + argc);
+
+	// run a scenario without window
+	if (!args.empty() && args[0] == "--headless")
+	{
+		Headless headless;
+
+		if (!headless.init(config, std::vector<std::string>(args.begin() + 1, args.end())))
+		{
+			return 1;
+		}
+
+		headless.run();
+		return 0;
+	}
+
+	Game game;
+
 	// start the game
 	if (game.init(config))
 	{
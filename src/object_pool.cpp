@@ -0,0 +1,94 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "object_pool.hpp"
+
+#include <algorithm>
+#include <new>
+
+static std::size_t round_up(const std::size_t size, const std::size_t align)
+{
+	return (size + align - 1) / align * align;
+}
+
+ObjectPool::ObjectPool(const std::size_t slot_size, const std::size_t slots_per_chunk):
+	slot_size(round_up(std::max(slot_size, sizeof(FreeSlot)), alignof(std::max_align_t))),
+	slots_per_chunk(slots_per_chunk)
+{}
+
+void* ObjectPool::allocate()
+{
+	size++;
+
+	// reuse the slot freed last, it is most likely still in the cache
+	if (free_list)
+	{
+		FreeSlot* free_slot = free_list;
+		free_list = free_slot->next;
+		return free_slot;
+	}
+
+	if (chunk < chunks.size() && slot == slots_per_chunk)
+	{
+		chunk++;
+		slot = 0;
+	}
+
+	if (chunk == chunks.size())
+	{
+		// slots are only aligned to alignof(std::max_align_t), which can be less than its size
+		const std::size_t bytes = slot_size * slots_per_chunk;
+		chunks.emplace_back(new std::max_align_t[(bytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t)]);
+	}
+
+	char* memory = reinterpret_cast<char*>(chunks[chunk].get());
+	return memory + slot_size * slot++;
+}
+
+void ObjectPool::free(void* slot)
+{
+	free_list = new (slot) FreeSlot{ free_list };
+	size--;
+}
+
+void ObjectPool::release()
+{
+	chunk = 0;
+	slot = 0;
+	free_list = nullptr;
+	size = 0;
+}
+
+std::size_t ObjectPool::get_slot_size() const
+{
+	return slot_size;
+}
+
+std::size_t ObjectPool::get_size() const
+{
+	return size;
+}
\ No newline at end of file
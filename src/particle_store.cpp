@@ -0,0 +1,99 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "particle_store.hpp"
+
+std::size_t ParticleStore::add()
+{
+	pos_x.push_back(0.0f);
+	pos_y.push_back(0.0f);
+	prev_pos_x.push_back(0.0f);
+	prev_pos_y.push_back(0.0f);
+	vel_x.push_back(0.0f);
+	vel_y.push_back(0.0f);
+	acc_x.push_back(0.0f);
+	acc_y.push_back(0.0f);
+	mass.push_back(0.0f);
+	radius.push_back(0.0f);
+	step_level.push_back(UINT8_MAX);
+	density.push_back(0.0f);
+	color.push_back(0xffffffff);
+
+	acc_valid = false;
+
+	return pos_x.size() - 1;
+}
+
+template<typename T>
+static void swap_remove(std::vector<T>& values, const std::size_t index)
+{
+	values[index] = values.back();
+	values.pop_back();
+}
+
+void ParticleStore::remove(const std::size_t index)
+{
+	swap_remove(pos_x, index);
+	swap_remove(pos_y, index);
+	swap_remove(prev_pos_x, index);
+	swap_remove(prev_pos_y, index);
+	swap_remove(vel_x, index);
+	swap_remove(vel_y, index);
+	swap_remove(acc_x, index);
+	swap_remove(acc_y, index);
+	swap_remove(mass, index);
+	swap_remove(radius, index);
+	swap_remove(step_level, index);
+	swap_remove(density, index);
+	swap_remove(color, index);
+
+	acc_valid = false;
+}
+
+std::size_t ParticleStore::size() const
+{
+	return pos_x.size();
+}
+
+void ParticleStore::clear()
+{
+	pos_x.clear();
+	pos_y.clear();
+	prev_pos_x.clear();
+	prev_pos_y.clear();
+	vel_x.clear();
+	vel_y.clear();
+	acc_x.clear();
+	acc_y.clear();
+	mass.clear();
+	radius.clear();
+	step_level.clear();
+	density.clear();
+	color.clear();
+
+	acc_valid = false;
+}
\ No newline at end of file
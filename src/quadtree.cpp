@@ -0,0 +1,264 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "quadtree.hpp"
+#include "gravity.hpp"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+void QuadTree::build(const float* pos_x, const float* pos_y, const float* mass, const std::size_t count)
+{
+	this->pos_x = pos_x;
+	this->pos_y = pos_y;
+	this->mass = mass;
+
+	nodes.clear();
+	indices.resize(count);
+	std::iota(indices.begin(), indices.end(), 0u);
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	// find the bounding square of all bodies
+	float min_x = pos_x[0], max_x = pos_x[0];
+	float min_y = pos_y[0], max_y = pos_y[0];
+
+	for (std::size_t i = 1; i < count; i++)
+	{
+		min_x = std::min(min_x, pos_x[i]);
+		max_x = std::max(max_x, pos_x[i]);
+		min_y = std::min(min_y, pos_y[i]);
+		max_y = std::max(max_y, pos_y[i]);
+	}
+
+	Node root;
+	root.center_x = (min_x + max_x) * 0.5f;
+	root.center_y = (min_y + max_y) * 0.5f;
+	// grow the square a bit, so bodies on the border are inside
+	root.half_size = std::max(max_x - min_x, max_y - min_y) * 0.5f * 1.001f + 1.0f;
+	root.first_child = 0;
+	root.begin = 0;
+	root.end = (std::uint32_t)count;
+
+	nodes.push_back(root);
+	subdivide(0, 0);
+}
+
+void QuadTree::subdivide(const std::uint32_t node, const unsigned int depth)
+{
+	// copy, nodes may reallocate while the children are pushed
+	const Node cell = nodes[node];
+
+	if (cell.end - cell.begin <= leaf_capacity || depth >= max_depth)
+	// leaf, sum up the bodies directly
+	{
+		float m = 0.0f, m_x = 0.0f, m_y = 0.0f;
+
+		for (std::uint32_t k = cell.begin; k < cell.end; k++)
+		{
+			const std::uint32_t i = indices[k];
+			m += mass[i];
+			m_x += mass[i] * pos_x[i];
+			m_y += mass[i] * pos_y[i];
+		}
+
+		nodes[node].mass = m;
+		nodes[node].com_x = m > 0.0f ? m_x / m : cell.center_x;
+		nodes[node].com_y = m > 0.0f ? m_y / m : cell.center_y;
+		return;
+	}
+
+	// sort the bodies into the quadrants, first by y, then both halves by x
+	const auto first = indices.begin() + cell.begin;
+	const auto last = indices.begin() + cell.end;
+
+	const auto mid_y = std::partition(first, last,
+		[&](const std::uint32_t i) { return pos_y[i] < cell.center_y; });
+	const auto mid_x_top = std::partition(first, mid_y,
+		[&](const std::uint32_t i) { return pos_x[i] < cell.center_x; });
+	const auto mid_x_bottom = std::partition(mid_y, last,
+		[&](const std::uint32_t i) { return pos_x[i] < cell.center_x; });
+
+	const std::array<std::uint32_t, 5> bounds =
+	{
+		cell.begin,
+		(std::uint32_t)(mid_x_top - indices.begin()),
+		(std::uint32_t)(mid_y - indices.begin()),
+		(std::uint32_t)(mid_x_bottom - indices.begin()),
+		cell.end
+	};
+
+	const float h = cell.half_size * 0.5f;
+	const std::uint32_t first_child = (std::uint32_t)nodes.size();
+	nodes[node].first_child = first_child;
+
+	for (std::uint32_t q = 0; q < 4; q++)
+	{
+		Node child;
+		child.center_x = cell.center_x + ((q % 2 == 0) ? -h : h);
+		child.center_y = cell.center_y + ((q < 2) ? -h : h);
+		child.half_size = h;
+		child.first_child = 0;
+		child.begin = bounds[q];
+		child.end = bounds[q + 1];
+
+		nodes.push_back(child);
+	}
+
+	float m = 0.0f, m_x = 0.0f, m_y = 0.0f;
+
+	for (std::uint32_t q = 0; q < 4; q++)
+	{
+		subdivide(first_child + q, depth + 1);
+
+		const Node& child = nodes[first_child + q];
+		m += child.mass;
+		m_x += child.mass * child.com_x;
+		m_y += child.mass * child.com_y;
+	}
+
+	nodes[node].mass = m;
+	nodes[node].com_x = m > 0.0f ? m_x / m : cell.center_x;
+	nodes[node].com_y = m > 0.0f ? m_y / m : cell.center_y;
+}
+
+void QuadTree::refit()
+{
+	// children are always stored after their parent, so going backwards sums them up first
+	for (std::size_t n = nodes.size(); n-- > 0;)
+	{
+		Node& node = nodes[n];
+		float m = 0.0f, m_x = 0.0f, m_y = 0.0f;
+
+		if (node.first_child == 0)
+		{
+			for (std::uint32_t k = node.begin; k < node.end; k++)
+			{
+				const std::uint32_t i = indices[k];
+				m += mass[i];
+				m_x += mass[i] * pos_x[i];
+				m_y += mass[i] * pos_y[i];
+			}
+		}
+		else
+		{
+			for (std::uint32_t q = 0; q < 4; q++)
+			{
+				const Node& child = nodes[node.first_child + q];
+				m += child.mass;
+				m_x += child.mass * child.com_x;
+				m_y += child.mass * child.com_y;
+			}
+		}
+
+		node.mass = m;
+		node.com_x = m > 0.0f ? m_x / m : node.center_x;
+		node.com_y = m > 0.0f ? m_y / m : node.center_y;
+	}
+}
+
+sf::Vector2f QuadTree::calc_acceleration(const float G, const float theta, const float eps_sq,
+	const std::size_t index) const
+{
+	if (nodes.empty())
+	{
+		return sf::Vector2f(0.0f, 0.0f);
+	}
+
+	const float x = pos_x[index];
+	const float y = pos_y[index];
+	const float theta_sq = theta * theta;
+
+	float a_x = 0.0f, a_y = 0.0f;
+
+	// every opened node replaces itself with 4 children, so 3 per level are enough
+	std::array<std::uint32_t, 3 * max_depth + 4> stack;
+	std::size_t top = 0;
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		const Node& node = nodes[stack[--top]];
+
+		if (node.mass <= 0.0f)
+		{
+			continue;
+		}
+
+		if (node.first_child == 0)
+		// leaf, sum the bodies directly
+		{
+			for (std::uint32_t k = node.begin; k < node.end; k++)
+			{
+				const std::uint32_t i = indices[k];
+
+				if (i == index)
+				{
+					continue;
+				}
+
+				Gravity::accumulate(pos_x[i] - x, pos_y[i] - y, mass[i], eps_sq, a_x, a_y);
+			}
+
+			continue;
+		}
+
+		const float d_x = node.com_x - x;
+		const float d_y = node.com_y - y;
+		const float r_sq = d_x * d_x + d_y * d_y;
+		const float size = node.half_size * 2.0f;
+
+		if (size * size < theta_sq * r_sq)
+		// far enough away, use the whole cell as one body
+		{
+			Gravity::accumulate(d_x, d_y, node.mass, eps_sq, a_x, a_y);
+		}
+		else
+		{
+			for (std::uint32_t q = 0; q < 4; q++)
+			{
+				stack[top++] = node.first_child + q;
+			}
+		}
+	}
+
+	return sf::Vector2f(G * a_x, G * a_y);
+}
+
+const std::vector<QuadTree::Node>& QuadTree::get_nodes() const
+{
+	return nodes;
+}
+
+const std::vector<std::uint32_t>& QuadTree::get_indices() const
+{
+	return indices;
+}
\ No newline at end of file
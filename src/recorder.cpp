@@ -0,0 +1,235 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "recorder.hpp"
+#include "byte_order.hpp"
+
+#include <cstring>
+
+Recorder::~Recorder()
+{
+	close();
+}
+
+bool Recorder::open(const std::string filename, const unsigned int every)
+{
+	close();
+
+	file.open(filename, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	Trajectory::Header header;
+	std::memcpy(header.magic, "SOLYSTRJ", 8);
+	header.version = Trajectory::version;
+	header.every = every;
+
+	to_little_endian(&header.version, 1);
+	to_little_endian(&header.every, 1);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	this->every = every > 0 ? every : 1;
+	step = 0;
+	dropped = 0;
+	offsets.clear();
+
+	free_buffers.clear();
+	full_buffers.clear();
+	for (std::size_t i = 0; i < buffer_count; i++)
+	{
+		free_buffers.push_back(i);
+	}
+
+	quit = false;
+	thread = std::thread(&Recorder::run, this);
+
+	return true;
+}
+
+void Recorder::close()
+{
+	if (!thread.joinable())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	wake.notify_one();
+	thread.join();
+
+	// the index of all frames, so readers can jump to any of them
+	Trajectory::Trailer trailer;
+	trailer.frames = offsets.size();
+	trailer.index = file.tellp();
+	std::memcpy(trailer.magic, "SOLYSIDX", 8);
+
+	to_little_endian(offsets.data(), offsets.size());
+	to_little_endian(&trailer.frames, 1);
+	to_little_endian(&trailer.index, 1);
+
+	file.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * 8);
+	file.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+	file.close();
+}
+
+void Recorder::record(const ParticleStore& particles, const double time)
+{
+	if (!thread.joinable() || ++step % every != 0)
+	{
+		return;
+	}
+
+	std::size_t index;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (free_buffers.empty())
+		{
+			dropped++;
+			return;
+		}
+
+		index = free_buffers.back();
+		free_buffers.pop_back();
+	}
+
+	// assign reuses the memory, only a copy unless the number of bodies grew
+	Buffer& buffer = buffers[index];
+	buffer.step = step;
+	buffer.time = time;
+	buffer.pos_x.assign(particles.pos_x.begin(), particles.pos_x.end());
+	buffer.pos_y.assign(particles.pos_y.begin(), particles.pos_y.end());
+	buffer.vel_x.assign(particles.vel_x.begin(), particles.vel_x.end());
+	buffer.vel_y.assign(particles.vel_y.begin(), particles.vel_y.end());
+	buffer.radius.assign(particles.radius.begin(), particles.radius.end());
+	buffer.color.assign(particles.color.begin(), particles.color.end());
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		full_buffers.push_back(index);
+	}
+	wake.notify_one();
+}
+
+bool Recorder::is_open() const
+{
+	return thread.joinable();
+}
+
+std::uint64_t Recorder::get_dropped() const
+{
+	return dropped;
+}
+
+void Recorder::run()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (true)
+	{
+		wake.wait(lock, [this] { return quit || !full_buffers.empty(); });
+
+		// write everything that is left before quitting
+		if (full_buffers.empty())
+		{
+			break;
+		}
+
+		const std::size_t index = full_buffers.front();
+		full_buffers.pop_front();
+
+		lock.unlock();
+		write_frame(buffers[index]);
+		lock.lock();
+
+		free_buffers.push_back(index);
+	}
+}
+
+void Recorder::write_frame(const Buffer& buffer)
+{
+	const std::vector<float>* arrays[4] = { &buffer.pos_x, &buffer.pos_y, &buffer.vel_x, &buffer.vel_y };
+	const std::size_t count = buffer.pos_x.size();
+
+	// key frames can be decoded on their own; radius and color are only stored in key frames,
+	// so edits, merges and bodies swapped into a freed slot need one too
+	const bool key = offsets.size() % Trajectory::key_interval == 0 || last[0].size() != count
+		|| buffer.radius != key_radius || buffer.color != key_color;
+	since_key = key ? 0 : since_key + 1;
+
+	Trajectory::FrameHeader header;
+	header.step = buffer.step;
+	header.time = buffer.time;
+	header.count = (std::uint32_t)count;
+	header.flags = key ? Trajectory::key_frame : 0;
+
+	encoded.clear();
+	for (unsigned int a = 0; a < 4; a++)
+	{
+		const std::size_t begin = encoded.size();
+		Trajectory::predict(last[a], before[a], since_key, count, prediction);
+		Trajectory::encode(arrays[a]->data(), prediction.data(), count, encoded);
+		header.size[a] = (std::uint32_t)(encoded.size() - begin);
+
+		before[a].swap(last[a]);
+		last[a] = *arrays[a];
+	}
+
+	// radius and color only go into key frames
+	if (key)
+	{
+		key_radius = buffer.radius;
+		key_color = buffer.color;
+	}
+
+	for (unsigned int a = 4; a < 6; a++)
+	{
+		const std::size_t begin = encoded.size();
+		if (key)
+		{
+			const void* values = a == 4 ? (const void*)buffer.radius.data() : (const void*)buffer.color.data();
+			Trajectory::encode(values, nullptr, count, encoded);
+		}
+		header.size[a] = (std::uint32_t)(encoded.size() - begin);
+	}
+
+	offsets.push_back(file.tellp());
+
+	to_little_endian(&header.step, 1);
+	to_little_endian(&header.time, 1);
+	to_little_endian(&header.count, 1);
+	to_little_endian(&header.flags, 1);
+	to_little_endian(header.size, 6);
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "renderer.hpp"
+
+void Renderer::prepare(const Snapshot& snapshot, const float alpha, const float pixels_per_unit, const sf::FloatRect& view)
+{
+	triangles.clear();
+	points.clear();
+
+	snapshot.find_visible(view, visible);
+
+	for (const std::uint32_t i: visible)
+	{
+		const float x = snapshot.prev_pos_x[i] + (snapshot.pos_x[i] - snapshot.prev_pos_x[i]) * alpha;
+		const float y = snapshot.prev_pos_y[i] + (snapshot.pos_y[i] - snapshot.prev_pos_y[i]) * alpha;
+		const float radius = snapshot.radius[i];
+		const float screen_radius = radius * pixels_per_unit;
+		sf::Color color(snapshot.color[i]);
+
+		if (screen_radius < point_radius)
+		{
+			// the covered part of the pixel, points are drawn additive so crowded pixels get brighter
+			const float coverage = std::max((float)M_PI * screen_radius * screen_radius, 0.05f);
+			color.a = (sf::Uint8)(color.a * std::min(coverage, 1.0f));
+
+			points.append(sf::Vertex(sf::Vector2f(x, y), color));
+		}
+		else if (screen_radius < large_radius)
+		{
+			add_quad(x, y, radius, color);
+		}
+		else
+		{
+			const float circumference = 2.0f * (float)M_PI * screen_radius;
+			const unsigned int segments = std::min(max_segments, (unsigned int)(circumference / segment_length));
+
+			add_polygon(x, y, radius, color, segments);
+		}
+	}
+}
+
+void Renderer::draw(sf::RenderWindow& window, const Snapshot& snapshot, const float alpha)
+{
+	if (!texture_created)
+	{
+		create_texture();
+	}
+
+	const sf::View& camera = window.getView();
+	const sf::FloatRect view(camera.getCenter() - camera.getSize() / 2.0f, camera.getSize());
+	const float pixels_per_unit = window.getSize().x / camera.getSize().x;
+
+	prepare(snapshot, alpha, pixels_per_unit, view);
+
+	sf::RenderStates point_states;
+	point_states.blendMode = sf::BlendAdd;
+
+	window.draw(points, point_states);
+	window.draw(triangles, &texture);
+}
+
+std::size_t Renderer::get_vertex_count() const
+{
+	return triangles.getVertexCount() + points.getVertexCount();
+}
+
+void Renderer::create_texture()
+{
+	sf::Image image;
+	image.create(texture_size, texture_size, sf::Color::Transparent);
+
+	// white disk with a one pixel wide smooth edge, the vertex color tints it
+	const float center = texture_size / 2.0f;
+	for (unsigned int y = 0; y < texture_size; y++)
+	{
+		for (unsigned int x = 0; x < texture_size; x++)
+		{
+			const float distance = std::hypot(x + 0.5f - center, y + 0.5f - center);
+			const float coverage = std::clamp(center - distance, 0.0f, 1.0f);
+
+			image.setPixel(x, y, sf::Color(255, 255, 255, (sf::Uint8)(coverage * 255.0f)));
+		}
+	}
+
+	texture.loadFromImage(image);
+	texture.setSmooth(true);
+	texture.generateMipmap();
+	texture_created = true;
+}
+
+void Renderer::add_quad(const float x, const float y, const float radius, const sf::Color color)
+{
+	const float size = (float)texture_size;
+
+	const sf::Vertex top_left(sf::Vector2f(x - radius, y - radius), color, sf::Vector2f(0.0f, 0.0f));
+	const sf::Vertex top_right(sf::Vector2f(x + radius, y - radius), color, sf::Vector2f(size, 0.0f));
+	const sf::Vertex bottom_right(sf::Vector2f(x + radius, y + radius), color, sf::Vector2f(size, size));
+	const sf::Vertex bottom_left(sf::Vector2f(x - radius, y + radius), color, sf::Vector2f(0.0f, size));
+
+	triangles.append(top_left);
+	triangles.append(top_right);
+	triangles.append(bottom_right);
+
+	triangles.append(top_left);
+	triangles.append(bottom_right);
+	triangles.append(bottom_left);
+}
+
+void Renderer::add_polygon(const float x, const float y, const float radius, const sf::Color color, const unsigned int segments)
+{
+	const sf::Vector2f center_tex(texture_size / 2.0f, texture_size / 2.0f);
+	const sf::Vertex center(sf::Vector2f(x, y), color, center_tex);
+
+	sf::Vertex last(sf::Vector2f(x + radius, y), color, center_tex);
+
+	for (unsigned int i = 1; i <= segments; i++)
+	{
+		const float angle = 2.0f * (float)M_PI * i / segments;
+		const sf::Vertex next(sf::Vector2f(x + std::cos(angle) * radius, y + std::sin(angle) * radius), color, center_tex);
+
+		triangles.append(center);
+		triangles.append(last);
+		triangles.append(next);
+
+		last = next;
+	}
+}
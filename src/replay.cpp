@@ -0,0 +1,276 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "replay.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+Replay::~Replay()
+{
+	close();
+}
+
+bool Replay::open(const std::string filename)
+{
+	close();
+
+	if (!trajectory.open(filename) || trajectory.get_frame_count() == 0)
+	{
+		trajectory.close();
+		return false;
+	}
+
+	frame_count = trajectory.get_frame_count();
+	for (Slot& slot: cache)
+	{
+		slot.index = SIZE_MAX;
+	}
+
+	wanted = 0;
+	position = 0.0;
+	playing = false;
+	shown_first = shown_second = SIZE_MAX;
+	has_snapshot = false;
+
+	quit = false;
+	thread = std::thread(&Replay::run, this);
+
+	return true;
+}
+
+void Replay::close()
+{
+	if (!thread.joinable())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	wake.notify_one();
+	thread.join();
+
+	trajectory.close();
+	frame_count = 0;
+}
+
+bool Replay::is_open() const
+{
+	return thread.joinable();
+}
+
+void Replay::update(const float time)
+{
+	if (!playing)
+	{
+		return;
+	}
+
+	position += time * speed;
+
+	// stop at the last frame
+	if (position >= frame_count - 1)
+	{
+		position = frame_count - 1;
+		playing = false;
+	}
+}
+
+const Snapshot* Replay::get_snapshot(float& alpha)
+{
+	const std::size_t first = (std::size_t)position;
+	const std::size_t second = std::min(first + 1, frame_count - 1);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (wanted != first)
+		{
+			wanted = first;
+			wake.notify_one();
+		}
+
+		const Slot* a = find(first);
+		const Slot* b = find(second);
+
+		// draw in between the two frames, the Renderer interpolates from prev_pos to pos
+		if (a && b && (first != shown_first || second != shown_second))
+		{
+			// bodies were added or removed in between, don't interpolate
+			const Trajectory::Frame& to = b->frame;
+			const Trajectory::Frame& from = a->frame.pos_x.size() == to.pos_x.size() ? a->frame : to;
+
+			snapshot.prev_pos_x = from.pos_x;
+			snapshot.prev_pos_y = from.pos_y;
+			snapshot.pos_x = to.pos_x;
+			snapshot.pos_y = to.pos_y;
+			snapshot.vel_x = to.vel_x;
+			snapshot.vel_y = to.vel_y;
+			snapshot.radius = to.radius;
+			snapshot.color = to.color;
+			snapshot.time = from.time;
+
+			// no tree to cull with, and nothing the ui can edit
+			snapshot.tree.reset();
+			snapshot.density.assign(to.pos_x.size(), 0.0f);
+			snapshot.name.assign(to.pos_x.size(), std::string());
+
+			shown_first = first;
+			shown_second = second;
+			has_snapshot = true;
+		}
+	}
+
+	if (!has_snapshot)
+	{
+		return nullptr;
+	}
+
+	// until the new frames are decoded the old ones stay, without moving
+	alpha = (first == shown_first && second != first) ? (float)(position - first) : 1.0f;
+	return &snapshot;
+}
+
+std::size_t Replay::get_frame_count() const
+{
+	return frame_count;
+}
+
+void Replay::set_position(const double position)
+{
+	this->position = std::clamp(position, 0.0, (double)(frame_count > 0 ? frame_count - 1 : 0));
+}
+
+double Replay::get_position() const
+{
+	return position;
+}
+
+void Replay::set_playing(const bool playing)
+{
+	this->playing = playing;
+}
+
+bool Replay::is_playing() const
+{
+	return playing;
+}
+
+void Replay::set_speed(const float speed)
+{
+	this->speed = speed;
+}
+
+float Replay::get_speed() const
+{
+	return speed;
+}
+
+void Replay::run()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (!quit)
+	{
+		// the first missing frame, starting at the shown one
+		const std::size_t start = wanted;
+		std::size_t missing = SIZE_MAX;
+
+		for (std::size_t i = start; i < std::min(start + read_ahead + 1, frame_count); i++)
+		{
+			if (!find(i))
+			{
+				missing = i;
+				break;
+			}
+		}
+
+		if (missing == SIZE_MAX)
+		{
+			wake.wait(lock, [this, start] { return quit || wanted != start; });
+			continue;
+		}
+
+		// reuse the slot farthest away from the shown frame, it is needed the least
+		Slot* slot = &cache[0];
+		for (Slot& candidate: cache)
+		{
+			if (candidate.index == SIZE_MAX)
+			{
+				slot = &candidate;
+				break;
+			}
+
+			const auto distance = [start](const std::size_t index)
+			{
+				return index < start ? (start - index) * 2 + read_ahead : index - start;
+			};
+
+			if (distance(candidate.index) > distance(slot->index))
+			{
+				slot = &candidate;
+			}
+		}
+
+		// decode without holding the lock, the render thread may use the other slots meanwhile,
+		// into the memory of the old frame, so nothing is allocated once the cache is full
+		Trajectory::Frame frame;
+		std::swap(frame, slot->frame);
+		slot->index = SIZE_MAX;
+		lock.unlock();
+
+		const bool ok = trajectory.read_frame(missing, frame);
+
+		lock.lock();
+
+		if (!ok)
+		{
+			// broken frame, stop reading ahead until something else is wanted
+			wake.wait(lock, [this, start] { return quit || wanted != start; });
+			continue;
+		}
+
+		slot->frame = std::move(frame);
+		slot->index = missing;
+	}
+}
+
+const Replay::Slot* Replay::find(const std::size_t index) const
+{
+	for (const Slot& slot: cache)
+	{
+		if (slot.index == index)
+		{
+			return &slot;
+		}
+	}
+
+	return nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "scenario.hpp"
+#include "celestial_body.hpp"
+#include "config.hpp"
+
+#include <cmath>
+#include <random>
+
+void Scenario::create(World& world, const Type type, const std::size_t count,
+	const unsigned int seed, const float size)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	switch (type)
+	{
+		case Type::random:
+		{
+			for (std::size_t i = 0; i < count; i++)
+			{
+				CelestialBody* cb = world.spawn<CelestialBody>(50.0f, 2.0f + 8.0f * unit(rng));
+				cb->set_pos(size * (2.0f * unit(rng) - 1.0f), size * (2.0f * unit(rng) - 1.0f));
+			}
+		}	break;
+
+		case Type::disk:
+		{
+			if (count == 0)
+			{
+				break;
+			}
+
+			const CelestialBody* star = world.spawn<CelestialBody>(1000.0f, size * 0.02f, sf::Color::Yellow);
+
+			for (std::size_t i = 1; i < count; i++)
+			{
+				// uniform over the area of the ring from 0.1 * size to size
+				const float r = size * std::sqrt(0.01f + 0.99f * unit(rng));
+				const float angle = 2.0f * (float)M_PI * unit(rng);
+
+				CelestialBody* cb = world.spawn<CelestialBody>(50.0f, 1.0f + 4.0f * unit(rng));
+				cb->set_pos(r * std::cos(angle), r * std::sin(angle));
+
+				// circular orbit around the star, counter clockwise
+				const float v = cb->calc_orbital_velocity(world.get_G(), star);
+				cb->set_vel(-v * std::sin(angle), v * std::cos(angle));
+			}
+		}	break;
+
+		default:
+			break;
+	}
+}
+
+bool Scenario::load(World& world, const std::string filename)
+{
+	Config config;
+
+	if (!config.load(filename))
+	{
+		return false;
+	}
+
+	const std::string name = config.get_value<std::string>("scenario", "type");
+	const unsigned int count = config.get_value<unsigned int>("scenario", "bodies");
+	const unsigned int seed = config.get_value<unsigned int>("scenario", "seed");
+	const float size = config.get_value<float>("scenario", "size");
+
+	for (const auto type: { Type::random, Type::disk })
+	{
+		if (name == get_name(type))
+		{
+			create(world, type, count, seed, size);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+const char* Scenario::get_name(const Type type)
+{
+	switch (type)
+	{
+		case Type::disk:
+			return "disk";
+
+		default:
+			return "random";
+	}
+}
\ No newline at end of file
@@ -0,0 +1,231 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "simulation.hpp"
+#include "checkpoint.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+Simulation::Simulation(World& world):
+	world(world)
+{}
+
+Simulation::~Simulation()
+{
+	stop();
+}
+
+void Simulation::start()
+{
+	if (thread.joinable())
+	{
+		return;
+	}
+
+	quit = false;
+
+	// so the renderer has something to show right away
+	publish(0.0f);
+
+	thread = std::thread(&Simulation::run, this);
+}
+
+void Simulation::stop()
+{
+	quit = true;
+
+	if (thread.joinable())
+	{
+		thread.join();
+	}
+}
+
+void Simulation::push(const Command command)
+{
+	std::lock_guard<std::mutex> lock(command_mutex);
+	commands.push_back(command);
+}
+
+void Simulation::set_running(const bool running)
+{
+	this->running = running;
+}
+
+bool Simulation::is_running() const
+{
+	return running;
+}
+
+void Simulation::set_time_step(const float time_step)
+{
+	this->time_step = time_step;
+}
+
+float Simulation::get_time_step() const
+{
+	return time_step;
+}
+
+void Simulation::set_max_substeps(const unsigned int max_substeps)
+{
+	this->max_substeps = max_substeps;
+}
+
+const Snapshot& Simulation::get_snapshot()
+{
+	return snapshots.get_front();
+}
+
+void Simulation::save_checkpoint(const std::string filename)
+{
+	push([this, filename](World& world)
+	{
+		if (!Checkpoint::save(world, time, filename))
+		{
+			std::cerr << "Could not save checkpoint " << filename << std::endl;
+		}
+	});
+}
+
+void Simulation::load_checkpoint(const std::string filename)
+{
+	push([this, filename](World& world)
+	{
+		if (!Checkpoint::load(world, time, filename))
+		{
+			std::cerr << "Could not load checkpoint " << filename << std::endl;
+		}
+	});
+}
+
+void Simulation::start_recording(const std::string filename, const unsigned int every)
+{
+	push([this, filename, every](World&)
+	{
+		if (!recorder.open(filename, every))
+		{
+			std::cerr << "Could not create recording " << filename << std::endl;
+		}
+	});
+}
+
+void Simulation::stop_recording()
+{
+	push([this](World&) { recorder.close(); });
+}
+
+void Simulation::run()
+{
+	typedef std::chrono::steady_clock Clock;
+
+	Clock::time_point last = Clock::now();
+	float accumulator = 0.0f;
+
+	while (!quit)
+	{
+		bool changed = execute_commands();
+
+		const Clock::time_point now = Clock::now();
+		const float frame_time = std::chrono::duration<float>(now - last).count();
+		float step = world.get_time_step(time_step);
+		last = now;
+
+		if (running)
+		{
+			accumulator += frame_time;
+
+			// step the world by time_step, or what the adaptive controller wants, no matter how much time passed
+			unsigned int substeps = 0;
+			while (accumulator >= step && substeps < max_substeps)
+			{
+				// only the last step of a frame is drawn in between, skip the copy for the others
+				if (accumulator - step < step || substeps + 1 == max_substeps)
+				{
+					world.keep_positions();
+				}
+
+				world.update(step);
+				time += step;
+				accumulator -= step;
+				substeps++;
+
+				recorder.record(world.get_particles(), time);
+
+				step = world.get_time_step(time_step);
+			}
+
+			// too slow, drop what can't be simulated instead of falling further behind
+			if (accumulator >= step)
+			{
+				accumulator = std::fmod(accumulator, step);
+			}
+
+			changed = changed || substeps > 0;
+		}
+		else
+		{
+			accumulator = 0.0f;
+		}
+
+		if (changed)
+		{
+			publish(accumulator);
+		}
+
+		// wait for the next step, but not too long so commands are handled quickly
+		const float wait = running ? std::min(step - accumulator, 0.002f) : 0.002f;
+		std::this_thread::sleep_for(std::chrono::duration<float>(std::max(wait, 0.0f)));
+	}
+}
+
+bool Simulation::execute_commands()
+{
+	std::vector<Command> queued;
+
+	{
+		std::lock_guard<std::mutex> lock(command_mutex);
+		queued.swap(commands);
+	}
+
+	for (const auto& command: queued)
+	{
+		command(world);
+	}
+
+	return !queued.empty();
+}
+
+void Simulation::publish(const float lag)
+{
+	Snapshot& snapshot = snapshots.get_back();
+	snapshot.capture(world, time, lag);
+	snapshot.recording = recorder.is_open();
+	snapshots.publish();
+}
\ No newline at end of file
@@ -0,0 +1,215 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "snapshot.hpp"
+
+void Snapshot::capture(const World& world, const double time, const float lag)
+{
+	const ParticleStore& particles = world.get_particles();
+
+	pos_x = particles.pos_x;
+	pos_y = particles.pos_y;
+	prev_pos_x = particles.prev_pos_x;
+	prev_pos_y = particles.prev_pos_y;
+	vel_x = particles.vel_x;
+	vel_y = particles.vel_y;
+	radius = particles.radius;
+	density = particles.density;
+	color = particles.color;
+
+	name.resize(particles.size());
+	handles.resize(particles.size());
+	handle_bodies.clear();
+
+	for (const auto& obj: world.get_objs())
+	{
+		const std::size_t index = obj->get_index();
+		const Handle handle = world.get_handle(index);
+
+		name[index] = obj->get_name();
+		handles[index] = handle;
+
+		if (handle.index >= handle_bodies.size())
+		{
+			handle_bodies.resize(handle.index + 1, Handle::invalid);
+		}
+		handle_bodies[handle.index] = (std::uint32_t)index;
+	}
+
+	// the tree of the last force calculation holds the current positions, so its cells only
+	// have to grow by the largest radius and step to hold the bodies in between the last two states;
+	// a few stars would make that margin huge for every cell, they are tested on their own
+	tree = world.get_tree();
+	large.clear();
+	if (tree != nullptr && !pos_x.empty())
+	{
+		float sum_radius = 0.0f, max_step = 0.0f;
+		for (std::size_t i = 0; i < pos_x.size(); i++)
+		{
+			sum_radius += radius[i];
+			max_step = std::max(max_step, std::max(std::abs(pos_x[i] - prev_pos_x[i]), std::abs(pos_y[i] - prev_pos_y[i])));
+		}
+
+		large_radius = 4.0f * sum_radius / (float)pos_x.size();
+
+		float max_radius = 0.0f;
+		for (std::uint32_t i = 0; i < (std::uint32_t)pos_x.size(); i++)
+		{
+			if (radius[i] > large_radius)
+			{
+				large.push_back(i);
+			}
+			else
+			{
+				max_radius = std::max(max_radius, radius[i]);
+			}
+		}
+
+		margin = max_radius + max_step;
+	}
+
+	solver = world.get_solver();
+	integrator = world.get_integrator();
+	theta = world.get_theta();
+	softening = world.get_softening();
+	collisions = world.get_collisions();
+	tolerance = world.get_tolerance();
+	step = world.get_last_step();
+	threads = world.get_threads();
+
+	this->time = time;
+	this->lag = lag;
+	taken = std::chrono::steady_clock::now();
+}
+
+void Snapshot::find_visible(const sf::FloatRect& rect, std::vector<std::uint32_t>& visible) const
+{
+	const float min_x = rect.left, max_x = rect.left + rect.width;
+	const float min_y = rect.top, max_y = rect.top + rect.height;
+
+	visible.clear();
+
+	// the body anywhere in between its last two states
+	const auto overlaps = [&](const std::uint32_t i)
+	{
+		const float r = radius[i];
+
+		return std::max(pos_x[i], prev_pos_x[i]) + r >= min_x && std::min(pos_x[i], prev_pos_x[i]) - r <= max_x &&
+			std::max(pos_y[i], prev_pos_y[i]) + r >= min_y && std::min(pos_y[i], prev_pos_y[i]) - r <= max_y;
+	};
+
+	// no tree, test every body
+	if (tree == nullptr)
+	{
+		for (std::uint32_t i = 0; i < (std::uint32_t)pos_x.size(); i++)
+		{
+			if (overlaps(i))
+			{
+				visible.push_back(i);
+			}
+		}
+
+		return;
+	}
+
+	for (const std::uint32_t i : large)
+	{
+		if (overlaps(i))
+		{
+			visible.push_back(i);
+		}
+	}
+
+	const std::vector<QuadTree::Node>& nodes = tree->get_nodes();
+	const std::vector<std::uint32_t>& indices = tree->get_indices();
+
+	if (nodes.empty())
+	{
+		return;
+	}
+
+	// every opened node replaces itself with 4 children, the tree is at most 32 levels deep
+	std::array<std::uint32_t, 3 * 32 + 4> stack;
+	std::size_t top = 0;
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		const QuadTree::Node& node = nodes[stack[--top]];
+		const float reach = node.half_size + margin;
+
+		// outside, skip the whole cell
+		if (node.center_x + reach < min_x || node.center_x - reach > max_x
+			|| node.center_y + reach < min_y || node.center_y - reach > max_y)
+		{
+			continue;
+		}
+
+		// completely inside or a leaf, take all bodies of the cell
+		const bool inside = node.center_x - reach >= min_x && node.center_x + reach <= max_x
+			&& node.center_y - reach >= min_y && node.center_y + reach <= max_y;
+		if (inside || node.first_child == 0)
+		{
+			for (std::uint32_t k = node.begin; k < node.end; k++)
+			{
+				// the large bodies are already in
+				if (radius[indices[k]] <= large_radius)
+				{
+					visible.push_back(indices[k]);
+				}
+			}
+			continue;
+		}
+
+		for (std::uint32_t q = 0; q < 4; q++)
+		{
+			stack[top++] = node.first_child + q;
+		}
+	}
+}
+
+std::optional<std::size_t> Snapshot::find(const Handle handle) const
+{
+	if (handle.index >= handle_bodies.size() || handle_bodies[handle.index] == Handle::invalid)
+	{
+		return std::nullopt;
+	}
+
+	// the slot may hold another body by now
+	const std::uint32_t index = handle_bodies[handle.index];
+	if (handles[index] != handle)
+	{
+		return std::nullopt;
+	}
+
+	return index;
+}
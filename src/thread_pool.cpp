@@ -0,0 +1,147 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(const unsigned int threads)
+{
+	unsigned int count = threads;
+
+	if (count == 0)
+	{
+		count = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// the calling thread is one of them
+	for (unsigned int i = 1; i < count; i++)
+	{
+		workers.emplace_back(&ThreadPool::work, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = true;
+	}
+
+	start_cond.notify_all();
+
+	for (auto& worker: workers)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::parallel_for(const std::size_t count, const std::size_t align,
+	const std::function<void(std::size_t, std::size_t)>& func)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	// a few chunks per thread, so uneven work is balanced
+	const std::size_t chunks = (workers.size() + 1) * 4;
+	std::size_t chunk = (count + chunks - 1) / chunks;
+	chunk = std::max(align, (chunk + align - 1) / align * align);
+
+	if (workers.empty() || chunk >= count)
+	{
+		func(0, count);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		job = &func;
+		job_count = count;
+		job_chunk = chunk;
+		next_chunk.store(0);
+		pending = (unsigned int)workers.size();
+		generation++;
+	}
+
+	start_cond.notify_all();
+	run_chunks();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	done_cond.wait(lock, [this] { return pending == 0; });
+	job = nullptr;
+}
+
+unsigned int ThreadPool::get_size() const
+{
+	return (unsigned int)workers.size() + 1;
+}
+
+void ThreadPool::work()
+{
+	unsigned long seen = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			start_cond.wait(lock, [&] { return stop || generation != seen; });
+
+			if (stop)
+			{
+				return;
+			}
+
+			seen = generation;
+		}
+
+		run_chunks();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			pending--;
+		}
+
+		done_cond.notify_one();
+	}
+}
+
+void ThreadPool::run_chunks()
+{
+	while (true)
+	{
+		const std::size_t begin = next_chunk.fetch_add(job_chunk);
+
+		if (begin >= job_count)
+		{
+			return;
+		}
+
+		(*job)(begin, std::min(begin + job_chunk, job_count));
+	}
+}
\ No newline at end of file
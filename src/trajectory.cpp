@@ -0,0 +1,462 @@
+/**
+ *	MIT LICENSE
+ * 
+ * 	Copyright (c) 2020 Kishimi
+ *		Contact:
+ * 			Anton Büttner
+ *			anton@green-pr.org
+ * 
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "trajectory.hpp"
+#include "byte_order.hpp"
+
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(sizeof(Trajectory::Header) == 16, "the header must not have padding");
+static_assert(sizeof(Trajectory::FrameHeader) == 48, "the frame header must not have padding");
+static_assert(sizeof(Trajectory::Trailer) == 24, "the trailer must not have padding");
+
+/* CODEC */
+
+void Trajectory::predict(const std::vector<float>& last, const std::vector<float>& before,
+	const std::size_t since_key, const std::size_t count, std::vector<float>& prediction)
+{
+	if (since_key == 0)
+	{
+		prediction.assign(count, 0.0f);
+	}
+	else if (since_key == 1)
+	{
+		prediction = last;
+	}
+	else
+	{
+		// no multiplication, so the compiler can't fuse it and reader and writer always agree
+		prediction.resize(last.size());
+		for (std::size_t i = 0; i < last.size(); i++)
+		{
+			prediction[i] = last[i] + (last[i] - before[i]);
+		}
+	}
+}
+
+void Trajectory::encode(const void* data, const void* prediction, const std::size_t count,
+	std::vector<std::uint8_t>& out)
+{
+	const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+	const std::uint8_t* predicted_bytes = static_cast<const std::uint8_t*>(prediction);
+
+	for (unsigned int plane = 0; plane < 4; plane++)
+	{
+		std::size_t zeros = 0;
+
+		for (std::size_t i = 0; i <= count; i++)
+		{
+			std::uint8_t byte = 0;
+
+			if (i < count)
+			{
+				std::uint32_t bits, predicted_bits = 0;
+				std::memcpy(&bits, bytes + i * 4, 4);
+				if (predicted_bytes)
+				{
+					std::memcpy(&predicted_bits, predicted_bytes + i * 4, 4);
+				}
+
+				byte = (std::uint8_t)((bits ^ predicted_bits) >> (plane * 8));
+
+				if (byte == 0)
+				{
+					zeros++;
+					continue;
+				}
+			}
+
+			// a run of zeros is a 0 and its length, 7 bits per byte
+			if (zeros > 0)
+			{
+				out.push_back(0);
+				for (; zeros >= 0x80; zeros >>= 7)
+				{
+					out.push_back((std::uint8_t)(zeros | 0x80));
+				}
+				out.push_back((std::uint8_t)zeros);
+				zeros = 0;
+			}
+
+			if (i < count)
+			{
+				out.push_back(byte);
+			}
+		}
+	}
+}
+
+bool Trajectory::decode(const std::uint8_t* in, const std::size_t size, void* data, const std::size_t count)
+{
+	std::uint8_t* bytes = static_cast<std::uint8_t*>(data);
+
+	std::size_t pos = 0;
+
+	for (unsigned int plane = 0; plane < 4; plane++)
+	{
+		std::size_t i = 0;
+
+		while (i < count)
+		{
+			if (pos >= size)
+			{
+				return false;
+			}
+
+			const std::uint8_t byte = in[pos++];
+
+			if (byte != 0)
+			{
+				if (bytes)
+				{
+					std::uint32_t bits;
+					std::memcpy(&bits, bytes + i * 4, 4);
+					bits ^= (std::uint32_t)byte << (plane * 8);
+					std::memcpy(bytes + i * 4, &bits, 4);
+				}
+
+				i++;
+				continue;
+			}
+
+			std::size_t zeros = 0;
+			for (unsigned int shift = 0; ; shift += 7)
+			{
+				if (pos >= size || shift > 56)
+				{
+					return false;
+				}
+
+				const std::uint8_t part = in[pos++];
+				zeros |= (std::size_t)(part & 0x7f) << shift;
+
+				if ((part & 0x80) == 0)
+				{
+					break;
+				}
+			}
+
+			i += zeros;
+		}
+
+		if (i != count)
+		{
+			return false;
+		}
+	}
+
+	return pos == size;
+}
+
+/* READING */
+
+Trajectory::~Trajectory()
+{
+	close();
+}
+
+bool Trajectory::open(const std::string filename)
+{
+	close();
+
+	const int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || (std::size_t)info.st_size < sizeof(Header))
+	{
+		::close(fd);
+		return false;
+	}
+
+	// the mapping stays valid after closing the file
+	void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+
+	if (mapping == MAP_FAILED)
+	{
+		return false;
+	}
+
+	data = static_cast<const std::uint8_t*>(mapping);
+	size = info.st_size;
+
+	Header header;
+	std::memcpy(&header, data, sizeof(header));
+	to_little_endian(&header.version, 1);
+	to_little_endian(&header.every, 1);
+
+	if (std::memcmp(header.magic, "SOLYSTRJ", 8) != 0 || header.version != version)
+	{
+		close();
+		return false;
+	}
+
+	every = header.every;
+
+	// a finished recording has an index at the end
+	if (size >= sizeof(Header) + sizeof(Trailer))
+	{
+		Trailer trailer;
+		std::memcpy(&trailer, data + size - sizeof(Trailer), sizeof(trailer));
+		to_little_endian(&trailer.frames, 1);
+		to_little_endian(&trailer.index, 1);
+
+		const std::uint64_t index_size = size - sizeof(Trailer);
+
+		if (std::memcmp(trailer.magic, "SOLYSIDX", 8) == 0 && trailer.index <= index_size
+			&& trailer.frames == (index_size - trailer.index) / 8
+			&& trailer.index + trailer.frames * 8 == index_size)
+		{
+			offsets.resize(trailer.frames);
+			std::memcpy(offsets.data(), data + trailer.index, trailer.frames * 8);
+			to_little_endian(offsets.data(), offsets.size());
+
+			// every frame has to lie in between the header and the index
+			bool valid = true;
+			for (std::size_t i = 0; i < offsets.size() && valid; i++)
+			{
+				valid = offsets[i] >= sizeof(Header) && offsets[i] <= trailer.index
+					&& get_frame_end(i) <= trailer.index;
+			}
+
+			if (valid)
+			{
+				return true;
+			}
+
+			// a broken index, the frames may still be fine
+			offsets.clear();
+		}
+	}
+
+	// no index, e.g. the recorder didn't stop cleanly, find all complete frames
+	std::uint64_t offset = sizeof(Header);
+	while (offset + sizeof(FrameHeader) <= size)
+	{
+		offsets.push_back(offset);
+		const std::uint64_t end = get_frame_end(offsets.size() - 1);
+
+		if (end > size)
+		{
+			offsets.pop_back();
+			break;
+		}
+
+		offset = end;
+	}
+
+	return true;
+}
+
+void Trajectory::close()
+{
+	if (data)
+	{
+		munmap(const_cast<std::uint8_t*>(data), size);
+	}
+
+	data = nullptr;
+	size = 0;
+	offsets.clear();
+	current_index = SIZE_MAX;
+}
+
+std::size_t Trajectory::get_frame_count() const
+{
+	return offsets.size();
+}
+
+unsigned int Trajectory::get_every() const
+{
+	return every;
+}
+
+bool Trajectory::read_frame(const std::size_t index, Frame& frame)
+{
+	if (index >= offsets.size())
+	{
+		return false;
+	}
+
+	// go back to the last key frame, unless the frame before is already decoded
+	std::size_t first = index;
+	while (index != current_index && first != current_index + 1)
+	{
+		if (read_frame_header(first).flags & key_frame)
+		{
+			break;
+		}
+
+		if (first == 0)
+		{
+			return false;
+		}
+
+		first--;
+	}
+
+	if (index == current_index)
+	{
+		first = index + 1;
+	}
+
+	for (std::size_t i = first; i <= index; i++)
+	{
+		// a zero run can still claim more bodies than fit into memory
+		bool decoded = false;
+		try
+		{
+			decoded = decode_frame(i);
+		}
+		catch (const std::bad_alloc&)
+		{}
+
+		if (!decoded)
+		{
+			current_index = SIZE_MAX;
+			return false;
+		}
+	}
+
+	frame = current;
+	return true;
+}
+
+Trajectory::FrameHeader Trajectory::read_frame_header(const std::size_t index) const
+{
+	FrameHeader header;
+	std::memcpy(&header, data + offsets[index], sizeof(header));
+
+	to_little_endian(&header.step, 1);
+	to_little_endian(&header.time, 1);
+	to_little_endian(&header.count, 1);
+	to_little_endian(&header.flags, 1);
+	to_little_endian(header.size, 6);
+
+	return header;
+}
+
+std::uint64_t Trajectory::get_frame_end(const std::size_t index) const
+{
+	if (offsets[index] + sizeof(FrameHeader) > size)
+	{
+		return UINT64_MAX;
+	}
+
+	const FrameHeader header = read_frame_header(index);
+
+	std::uint64_t end = offsets[index] + sizeof(FrameHeader);
+	for (const std::uint32_t array_size: header.size)
+	{
+		end += array_size;
+	}
+
+	return end;
+}
+
+bool Trajectory::decode_frame(const std::size_t index)
+{
+	const FrameHeader header = read_frame_header(index);
+
+	const bool key = header.flags & key_frame;
+	if (!key && current.pos_x.size() != header.count)
+	{
+		return false;
+	}
+
+	// a key frame sets the number of bodies, it has to fit the compressed arrays before anything is allocated
+	const std::uint8_t* in = data + offsets[index] + sizeof(FrameHeader);
+
+	if (key)
+	{
+		const std::uint8_t* array = in;
+		for (const std::uint32_t array_size: header.size)
+		{
+			if (!decode(array, array_size, nullptr, header.count))
+			{
+				return false;
+			}
+
+			array += array_size;
+		}
+	}
+
+	// current gets the new frame, before gets the last one
+	std::swap(current, before);
+	since_key = key ? 0 : since_key + 1;
+
+	std::vector<float>* arrays[4] = { &current.pos_x, &current.pos_y, &current.vel_x, &current.vel_y };
+	const std::vector<float>* last[4] = { &before.pos_x, &before.pos_y, &before.vel_x, &before.vel_y };
+
+	for (unsigned int a = 0; a < 4; a++)
+	{
+		// current still holds the frame before the last one, which the prediction needs
+		std::vector<float>& values = *arrays[a];
+		predict(*last[a], values, since_key, header.count, prediction);
+		values.swap(prediction);
+
+		if (!decode(in, header.size[a], values.data(), values.size()))
+		{
+			return false;
+		}
+
+		in += header.size[a];
+	}
+
+	// radius and color only change with key frames
+	if (key)
+	{
+		current.radius.assign(header.count, 0.0f);
+		current.color.assign(header.count, 0);
+
+		if (!decode(in, header.size[4], current.radius.data(), header.count)
+			|| !decode(in + header.size[4], header.size[5], current.color.data(), header.count))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		current.radius = before.radius;
+		current.color = before.color;
+	}
+
+	current.step = header.step;
+	current.time = header.time;
+	current_index = index;
+	return true;
+}
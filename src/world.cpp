@@ -26,86 +26,588 @@
  */
 
 #include "world.hpp"
+#include "gravity.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
 
 World::World(const float G):
-	G(G)
+	G(G),
+	pool(new ThreadPool(1)),
+	integrator(Integrator::create(integrator_type, G))
 {}
 
 World::~World()
 {
+	clear();
+}
+
+void World::clear()
+{
+	// the objects live in object_pool, so only destroy them and hand back all memory at once
 	for (std::size_t i = 0; i < objects.size(); i++)
 	{
 		if (objects[i])
 		{
-			delete objects[i];
+			objects[i]->~GameObject();
 		}
 	}
 
+	object_pool.release();
 	objects.clear();
+	object_slots.clear();
+	particles.clear();
+
+	slots.clear();
+	free_slot = Handle::invalid;
+	next_id = 0;
+
+	step_estimate = 0.0f;
+	last_step = 0.0f;
 }
 
 /* UPDATE FUNCTIONS */
 
 void World::update(const float time)
 {
-	for (auto& obj: objects)
+	if (time > 0.0f)
 	{
-		switch (obj->type)
+		// bodies that were added, removed or moved since the last step make the jerk meaningless
+		const bool adaptive = tolerance > 0.0f && particles.acc_valid;
+		if (adaptive)
 		{
-			case GameObject::Type::celestial_body:
-				update(time, static_cast<CelestialBody*>(obj));
-				break;
+			old_acc_x = particles.acc_x;
+			old_acc_y = particles.acc_y;
+		}
+
+		integrator->step(particles, [this] { compute_accelerations(); },
+			[this](const std::vector<std::uint32_t>& active) { compute_accelerations(active); }, time);
 
-			default:
-				update(time, obj);
-				break;
+		// only yoshida and wisdom-holman cost an extra force calculation, the others reuse it next step
+		if (tolerance > 0.0f && !particles.acc_valid)
+		{
+			compute_accelerations();
+			particles.acc_valid = true;
+		}
+
+		if (adaptive)
+		{
+			estimate_time_step(time);
 		}
+
+		last_step = time;
 	}
+
+	if (collisions)
+	{
+		resolve_collisions();
+	}
+}
+
+float World::get_time_step(const float max_time) const
+{
+	if (tolerance <= 0.0f)
+	{
+		return max_time;
+	}
+
+	// start small and let the step grow, it may at most double per step
+	const float step = step_estimate > 0.0f ? std::min(step_estimate, last_step * 2.0f) : max_time / 16.0f;
+
+	// a tiny step during a close encounter would stall the simulation
+	return std::clamp(step, max_time / 1024.0f, max_time);
 }
 
-void World::update(const float time, GameObject* obj) const
+float World::get_last_step() const
 {
-	obj->update(time);
+	return last_step;
 }
 
-void World::update(const float time, CelestialBody* obj) const
+void World::estimate_time_step(const float time)
 {
-	float F, a, angle;
-	sf::Vector2f acceleration;
+	const std::size_t count = particles.size();
 
-	for (const auto& other: objects)
+	// |a| / |j| is roughly the time the acceleration of a body needs to change completely
+	float min_ratio_sq = INFINITY;
+	for (std::size_t i = 0; i < count; i++)
 	{
-		if (!obj->compare(other))
+		const float j_x = particles.acc_x[i] - old_acc_x[i];
+		const float j_y = particles.acc_y[i] - old_acc_y[i];
+		const float j_sq = j_x * j_x + j_y * j_y;
+
+		if (j_sq > 0.0f)
 		{
-			F = obj->calc_gravitation(G, other);
-			a = obj->calc_acceleration(F);
-			angle = obj->calc_angle(other);
-			acceleration = obj->calc_angle_to_vec(angle) * a;
-			obj->accelerate(acceleration * time);
+			const float a_sq = particles.acc_x[i] * particles.acc_x[i] + particles.acc_y[i] * particles.acc_y[i];
+			min_ratio_sq = std::min(min_ratio_sq, a_sq / j_sq);
 		}
 	}
 
-	obj->update(time);
+	// j is the change over the whole step, without any change the step may grow without limit
+	step_estimate = tolerance * std::sqrt(min_ratio_sq) * time;
 }
 
-/* DRAW FUNCTIONS */
+void World::compute_accelerations()
+{
+	tree_current = solver == Solver::barnes_hut;
+
+	switch (solver)
+	{
+		case Solver::direct:
+			compute_direct();
+			break;
+
+		case Solver::direct_symmetric:
+			compute_direct_symmetric();
+			break;
+
+		case Solver::barnes_hut:
+			compute_barnes_hut();
+			break;
 
-void World::draw(sf::RenderWindow& window)
+		default:
+			break;
+	}
+}
+
+void World::compute_accelerations(const std::vector<std::uint32_t>& active)
 {
-	for (const auto& obj: objects)
+	const std::size_t count = particles.size();
+
+	if (solver == Solver::barnes_hut)
 	{
-		obj->draw(window);
+		// all bodies cost O(N log N) anyway, so rebuild then, a substep of a few bodies only refits the cells;
+		// a tree a Snapshot still holds must not change
+		if (active.size() == count || tree.use_count() > 1 || tree->get_indices().size() != count)
+		{
+			build_tree();
+		}
+		else
+		{
+			tree->refit();
+		}
+
+		tree_current = true;
+
+		pool->parallel_for(active.size(), 1, [&](const std::size_t begin, const std::size_t end)
+		{
+			for (std::size_t k = begin; k < end; k++)
+			{
+				const std::uint32_t i = active[k];
+				const sf::Vector2f a = tree->calc_acceleration(G, theta, softening * softening, i);
+				particles.acc_x[i] = a.x;
+				particles.acc_y[i] = a.y;
+			}
+		});
+
+		return;
+	}
+
+	tree_current = false;
+
+	// the direct sums only differ in how they visit pairs, gather the active bodies for the plain one
+	const std::size_t active_count = active.size();
+	active_pos_x.resize(active_count);
+	active_pos_y.resize(active_count);
+	active_acc_x.resize(active_count);
+	active_acc_y.resize(active_count);
+
+	for (std::size_t k = 0; k < active_count; k++)
+	{
+		active_pos_x[k] = particles.pos_x[active[k]];
+		active_pos_y[k] = particles.pos_y[active[k]];
+	}
+
+	pool->parallel_for(active_count, Gravity::block_size, [&](const std::size_t begin, const std::size_t end)
+	{
+		Gravity::direct_at(G, softening * softening,
+			particles.pos_x.data(), particles.pos_y.data(), particles.mass.data(), count,
+			active_pos_x.data() + begin, active_pos_y.data() + begin, end - begin,
+			active_acc_x.data() + begin, active_acc_y.data() + begin);
+
+		for (std::size_t k = begin; k < end; k++)
+		{
+			particles.acc_x[active[k]] = active_acc_x[k];
+			particles.acc_y[active[k]] = active_acc_y[k];
+		}
+	});
+}
+
+void World::compute_direct()
+{
+	const std::size_t count = particles.size();
+
+	// chunks are aligned to the vector width so the results don't depend on the thread count
+	pool->parallel_for(count, Gravity::block_size, [&](const std::size_t begin, const std::size_t end)
+	{
+		Gravity::direct(G, softening * softening,
+			particles.pos_x.data(), particles.pos_y.data(), particles.mass.data(), count,
+			begin, end, particles.acc_x.data(), particles.acc_y.data());
+	});
+}
+
+void World::compute_direct_symmetric()
+{
+	Gravity::direct_symmetric(G, softening * softening,
+		particles.pos_x.data(), particles.pos_y.data(), particles.mass.data(), particles.size(),
+		particles.acc_x.data(), particles.acc_y.data(), *pool);
+}
+
+void World::compute_barnes_hut()
+{
+	const std::size_t count = particles.size();
+
+	build_tree();
+
+	pool->parallel_for(count, 1, [&](const std::size_t begin, const std::size_t end)
+	{
+		for (std::size_t i = begin; i < end; i++)
+		{
+			const sf::Vector2f a = tree->calc_acceleration(G, theta, softening * softening, i);
+			particles.acc_x[i] = a.x;
+			particles.acc_y[i] = a.y;
+		}
+	});
+}
+
+void World::build_tree()
+{
+	// a Snapshot may still read the last tree, then build into one that no Snapshot holds
+	if (tree.use_count() > 1)
+	{
+		const auto free = std::find_if(spare_trees.begin(), spare_trees.end(),
+			[](const std::shared_ptr<QuadTree>& spare) { return spare.use_count() == 1; });
+
+		if (free != spare_trees.end())
+		{
+			std::swap(*free, tree);
+		}
+		else
+		{
+			spare_trees.push_back(tree);
+			tree = std::make_shared<QuadTree>();
+		}
+	}
+
+	tree->build(particles.pos_x.data(), particles.pos_y.data(), particles.mass.data(), particles.size());
+}
+
+void World::resolve_collisions()
+{
+	broad_phase.find(particles, collision_pairs);
+
+	if (collision_pairs.empty())
+	{
+		return;
+	}
+
+	// merge in order of the pairs, a body that was absorbed takes no part in later pairs
+	std::vector<bool> absorbed(particles.size(), false);
+	std::vector<Handle> destroyed;
+
+	for (const auto& [a, b]: collision_pairs)
+	{
+		if (absorbed[a] || absorbed[b])
+		{
+			continue;
+		}
+
+		// the heavier body survives and keeps its name and color
+		const std::uint32_t i = particles.mass[a] >= particles.mass[b] ? a : b;
+		const std::uint32_t j = i == a ? b : a;
+
+		const float m_i = particles.mass[i], m_j = particles.mass[j];
+		const float m = m_i + m_j;
+		const float w_i = m_i / m, w_j = m_j / m;
+
+		particles.pos_x[i] = particles.pos_x[i] * w_i + particles.pos_x[j] * w_j;
+		particles.pos_y[i] = particles.pos_y[i] * w_i + particles.pos_y[j] * w_j;
+		particles.prev_pos_x[i] = particles.prev_pos_x[i] * w_i + particles.prev_pos_x[j] * w_j;
+		particles.prev_pos_y[i] = particles.prev_pos_y[i] * w_i + particles.prev_pos_y[j] * w_j;
+		particles.vel_x[i] = particles.vel_x[i] * w_i + particles.vel_x[j] * w_j;
+		particles.vel_y[i] = particles.vel_y[i] * w_i + particles.vel_y[j] * w_j;
+
+		// the volumes add up, the density follows from mass and volume
+		const float volume = CelestialBody::calc_volume(particles.radius[i])
+			+ CelestialBody::calc_volume(particles.radius[j]);
+
+		particles.mass[i] = m;
+		particles.density[i] = m / volume;
+		particles.radius[i] = std::cbrt(volume * 3.0f / (4.0f * (float)M_PI));
+
+		absorbed[j] = true;
+		destroyed.push_back(get_handle(j));
+	}
+
+	// the masses and positions changed
+	particles.acc_valid = false;
+
+	for (const Handle handle: destroyed)
+	{
+		destroy(handle);
 	}
 }
 
 /* OTHER FUNCTIONS */
 
-void World::spawn(GameObject* obj)
+void World::load_settings(const Config& config)
 {
-	objects.push_back(obj);
+	set_threads(config.get_value<unsigned int>("advanced", "threads"));
+
+	const std::string solver = config.get_value<std::string>("physics", "solver");
+
+	for (const auto type: { Solver::barnes_hut, Solver::direct, Solver::direct_symmetric })
+	{
+		if (solver == get_solver_name(type))
+		{
+			set_solver(type);
+		}
+	}
+
+	const float theta = config.get_value<float>("physics", "theta");
+	if (theta > 0.0f)
+	{
+		set_theta(theta);
+	}
+
+	set_softening(config.get_value<float>("physics", "softening"));
+	set_collisions(config.get_value<bool>("physics", "collisions"));
+	set_tolerance(config.get_value<float>("physics", "tolerance"));
+
+	const std::string integrator = config.get_value<std::string>("physics", "integrator");
+
+	for (const auto type: { Integrator::Type::euler, Integrator::Type::leapfrog,
+		Integrator::Type::velocity_verlet, Integrator::Type::yoshida, Integrator::Type::block,
+		Integrator::Type::wisdom_holman })
+	{
+		if (integrator == Integrator::get_name(type))
+		{
+			set_integrator(type);
+		}
+	}
+}
+
+float World::get_G() const
+{
+	return G;
 }
 
 std::vector<GameObject*> World::get_objs() const
 {
 	return objects;
+}
+
+GameObject* World::get_obj(const std::size_t index) const
+{
+	return objects[index];
+}
+
+GameObject* World::get_obj(const Handle handle) const
+{
+	const std::optional<std::size_t> index = find(handle);
+	return index ? objects[*index] : nullptr;
+}
+
+Handle World::get_handle(const std::size_t index) const
+{
+	const std::uint32_t slot = object_slots[index];
+	return Handle{ slot, slots[slot].generation };
+}
+
+std::optional<std::size_t> World::find(const Handle handle) const
+{
+	// a freed slot has a new generation, so old handles don't match
+	if (handle.index >= slots.size() || slots[handle.index].generation != handle.generation)
+	{
+		return std::nullopt;
+	}
+
+	return slots[handle.index].object;
+}
+
+bool World::destroy(const Handle handle)
+{
+	const std::optional<std::size_t> found = find(handle);
+	if (!found)
+	{
+		return false;
+	}
+
+	const std::size_t index = *found;
+	const std::size_t last = objects.size() - 1;
+
+	objects[index]->~GameObject();
+	object_pool.free(objects[index]);
+
+	// move the last object into the gap, the particles do the same
+	if (index != last)
+	{
+		objects[index] = objects[last];
+		objects[index]->set_index(index);
+		object_slots[index] = object_slots[last];
+		slots[object_slots[index]].object = (std::uint32_t)index;
+	}
+
+	objects.pop_back();
+	object_slots.pop_back();
+	particles.remove(index);
+
+	Slot& slot = slots[handle.index];
+	slot.generation++;
+	slot.object = free_slot;
+	free_slot = handle.index;
+
+	return true;
+}
+
+void World::add_object(GameObject* obj)
+{
+	std::uint32_t slot = free_slot;
+
+	if (slot != Handle::invalid)
+	{
+		free_slot = slots[slot].object;
+	}
+	else
+	{
+		slot = (std::uint32_t)slots.size();
+		slots.push_back(Slot{ 0, 0 });
+	}
+
+	slots[slot].object = (std::uint32_t)objects.size();
+	objects.push_back(obj);
+	object_slots.push_back(slot);
+
+	obj->set_name(std::to_string(next_id++));
+}
+
+void World::reserve_name(const std::string& name)
+{
+	unsigned long id = 0;
+	const char* last = name.data() + name.size();
+	const auto [end, error] = std::from_chars(name.data(), last, id);
+
+	if (!name.empty() && error == std::errc() && end == last
+		&& id >= next_id && id < std::numeric_limits<unsigned long>::max())
+	{
+		next_id = id + 1;
+	}
+}
+
+void World::keep_positions()
+{
+	particles.prev_pos_x = particles.pos_x;
+	particles.prev_pos_y = particles.pos_y;
+}
+
+const ParticleStore& World::get_particles() const
+{
+	return particles;
+}
+
+ParticleStore& World::get_particles()
+{
+	return particles;
+}
+
+std::shared_ptr<const QuadTree> World::get_tree() const
+{
+	// valid accelerations were calculated from the current positions, so was the tree
+	if (!tree_current || !particles.acc_valid || tree->get_indices().size() != particles.size())
+	{
+		return nullptr;
+	}
+
+	return tree;
+}
+
+void World::set_solver(const Solver solver)
+{
+	this->solver = solver;
+	particles.acc_valid = false;
+}
+
+World::Solver World::get_solver() const
+{
+	return solver;
+}
+
+const char* World::get_solver_name(const Solver solver)
+{
+	switch (solver)
+	{
+		case Solver::direct:
+			return "direct";
+
+		case Solver::direct_symmetric:
+			return "direct-symmetric";
+
+		default:
+			return "barnes-hut";
+	}
+}
+
+void World::set_theta(const float theta)
+{
+	this->theta = theta;
+	particles.acc_valid = false;
+}
+
+float World::get_theta() const
+{
+	return theta;
+}
+
+void World::set_softening(const float softening)
+{
+	this->softening = softening;
+	particles.acc_valid = false;
+}
+
+float World::get_softening() const
+{
+	return softening;
+}
+
+void World::set_integrator(const Integrator::Type type)
+{
+	integrator_type = type;
+	integrator.reset(Integrator::create(type, G));
+}
+
+Integrator::Type World::get_integrator() const
+{
+	return integrator_type;
+}
+
+void World::set_collisions(const bool collisions)
+{
+	this->collisions = collisions;
+}
+
+bool World::get_collisions() const
+{
+	return collisions;
+}
+
+void World::set_tolerance(const float tolerance)
+{
+	this->tolerance = tolerance;
+	step_estimate = 0.0f;
+}
+
+float World::get_tolerance() const
+{
+	return tolerance;
+}
+
+void World::set_threads(const unsigned int threads)
+{
+	pool.reset(new ThreadPool(threads));
+}
+
+unsigned int World::get_threads() const
+{
+	return pool->get_size();
 }
\ No newline at end of file